@@ -1,40 +1,495 @@
 #include <stdio.h>    // 标准输入输出库
-#include <stdlib.h>   // 标准库，用于 rand() 和 srand()
+#include <stdlib.h>   // 标准库，用于 malloc() 和 qsort()
 #include <string.h>   // 字符串操作库，用于 memcpy()
-#include <time.h>     // 时间库，用于 time()，为 rand() 提供种子
+#include <time.h>     // 时间库，用于 time()，为随机数生成器提供默认种子
+#include <pthread.h>  // 线程库，参数扫描时并行运行
+#include <limits.h>   // INT_MAX
+#include <math.h>     // log()、pow()、exp()，工作负载生成器的分布抽样
+#ifdef __AVX2__
+#include <immintrin.h> // AVX2 指令，用于进程表的向量化扫描
+#endif
+#ifdef _WIN32
+#include <windows.h>  // GetSystemInfo()，获取 CPU 核数
+#include <psapi.h>    // GetProcessMemoryInfo()，获取内存峰值
+#else
+#include <unistd.h>   // sysconf()，获取 CPU 核数
+#include <sys/resource.h> // getrusage()，获取内存峰值
+#endif
 
-#define MAX_PROCESSES 5   // 最大进程数
+#define MAX_PROCESSES 5   // 默认进程数（可由命令行参数指定更多）
 #define TIME_SLICE 2      // 时间片轮转算法的时间片大小
 
+// CPU/I-O 区间：进程交替执行 CPU 区间和 I/O 区间，以 CPU 区间开始和结束
+typedef struct {
+    int length;  // 区间长度
+    int device;  // I/O 区间使用的设备号，CPU 区间为 -1
+} Burst;
+
 // 进程控制块 (PCB) 结构体
 typedef struct {
     char name[10];      // 进程名
+    int pid;            // 进程序号（预先生成时为下标，轨迹回放时为记录序号），优先级相同时序号小者在前
     int priority;       // 优先级（可用于高响应比计算）
     int arrival_time;   // 到达时间
-    int burst_time;     // 需要运行时间（进程长度）
-    int remaining_time; // 剩余运行时间
+    int burst_time;     // 当前 CPU 区间的运行时间（只有一个区间时即进程长度）
+    int remaining_time; // 当前 CPU 区间的剩余运行时间
     int start_time;     // 进程开始运行的时间
     int finish_time;    // 进程完成的时间
     int turnaround_time; // 周转时间
-    char state;         // 进程状态：'W' (等待/就绪), 'R' (运行), 'F' (完成)
+    char state;         // 进程状态：'W' (等待/就绪), 'R' (运行), 'B' (阻塞，等待 I/O), 'F' (完成)
+    char queued;        // 是否已在 RR 运行队列中
+    int affinity;       // CPU 亲和性提示（多 CPU 模拟），-1 表示无
+    int cpu;            // 上次运行所在的 CPU，-1 表示尚未运行
+    int period;         // 周期任务的周期，0 表示非周期进程
+    int deadline;       // 绝对截止时间，-1 表示无截止时间
+    int ready_time;     // 最近一次进入就绪状态的时间（到达或 I/O 完成）
+    int cpu_time;       // 所有 CPU 区间的总长
+    int io_time;        // 所有 I/O 区间的总长
+    Burst *bursts;      // 区间序列，NULL 表示只有一个长度为 burst_time 的 CPU 区间
+    int num_bursts;     // 区间数（奇数）
+    int burst_index;    // 当前区间下标
 } PCB;
 
-// 函数：用随机数据初始化进程
-void initializeProcesses(PCB processes[], int num_processes) {
-    srand(time(NULL)); // 使用当前时间作为随机数种子
+// 输出详细程度
+#define VERBOSITY_SILENT 0 // 不输出（参数扫描）
+#define VERBOSITY_RESULT 1 // 只输出平均周转时间（大规模运行、轨迹回放）
+#define VERBOSITY_STATUS 2 // 每次调度后输出 PCB 信息
+
+// --- 到达流：按 (到达时间, 下标) 排序的进程序列 ---
+typedef struct {
+    int arrival_time; // 到达时间
+    int idx;          // 进程下标
+} ArrivalEntry;
+
+// 函数：到达流排序比较，到达时间相同时下标小者在前
+int compareArrival(const void *a, const void *b) {
+    const ArrivalEntry *x = (const ArrivalEntry *)a;
+    const ArrivalEntry *y = (const ArrivalEntry *)b;
+    if (x->arrival_time != y->arrival_time) {
+        return (x->arrival_time < y->arrival_time) ? -1 : 1;
+    }
+    return (x->idx < y->idx) ? -1 : (x->idx > y->idx);
+}
+
+// 函数：生成按到达时间排序的到达流，调度时只需顺序推进游标
+ArrivalEntry* buildArrivalStream(PCB processes[], int num_processes) {
+    ArrivalEntry *stream = (ArrivalEntry *)malloc(sizeof(ArrivalEntry) * num_processes);
+    if (stream == NULL) {
+        perror("Failed to allocate arrival stream");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_processes; i++) {
+        stream[i].arrival_time = processes[i].arrival_time;
+        stream[i].idx = i;
+    }
+    qsort(stream, num_processes, sizeof(ArrivalEntry), compareArrival);
+    return stream;
+}
+
+// 函数：realloc 的包装，分配失败时退出
+void* checkedRealloc(void *ptr, size_t size) {
+    void *p = realloc(ptr, size);
+    if (p == NULL) {
+        perror("Failed to allocate memory");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// 函数：复制一份进程数据，避免影响其他算法
+PCB* copyProcesses(PCB processes[], int num_processes) {
+    PCB *copy = (PCB *)malloc(sizeof(PCB) * num_processes);
+    if (copy == NULL) {
+        perror("Failed to allocate process table");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy, processes, sizeof(PCB) * num_processes);
+    return copy;
+}
+
+// --- 就绪队列：存放进程下标的二叉堆 ---
+// before(processes, a, b) 返回非零表示进程 a 应先于进程 b 被调度
+typedef int (*ProcessOrder)(const PCB processes[], int a, int b);
+
+typedef struct {
+    int *items;             // 堆数组，存放进程下标
+    int size;               // 当前元素个数
+    int capacity;           // 堆数组容量
+    ProcessOrder before;    // 排序规则
+} ProcessHeap;
+
+// 函数：SJF 排序规则，爆发时间短者优先，相同时序号小者优先（与逐个扫描的结果一致）
+int shorterBurst(const PCB processes[], int a, int b) {
+    if (processes[a].burst_time != processes[b].burst_time) {
+        return processes[a].burst_time < processes[b].burst_time;
+    }
+    return processes[a].pid < processes[b].pid;
+}
+
+void heapInit(ProcessHeap *heap, ProcessOrder before) {
+    heap->capacity = 16;
+    heap->items = (int *)malloc(sizeof(int) * heap->capacity);
+    if (heap->items == NULL) {
+        perror("Failed to allocate ready heap");
+        exit(EXIT_FAILURE);
+    }
+    heap->size = 0;
+    heap->before = before;
+}
+
+void heapFree(ProcessHeap *heap) {
+    free(heap->items);
+    heap->items = NULL;
+    heap->size = heap->capacity = 0;
+}
+
+// 函数：进程入堆（上浮），堆满时容量翻倍
+// 进程表在流式输入时可能扩容搬移，因此每次操作都传入当前的进程表
+void heapPush(ProcessHeap *heap, const PCB processes[], int idx) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->items = (int *)realloc(heap->items, sizeof(int) * heap->capacity);
+        if (heap->items == NULL) {
+            perror("Failed to grow ready heap");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int pos = heap->size++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!heap->before(processes, idx, heap->items[parent])) {
+            break;
+        }
+        heap->items[pos] = heap->items[parent];
+        pos = parent;
+    }
+    heap->items[pos] = idx;
+}
+
+// 函数：取出堆顶进程（下沉），堆为空时返回 -1
+int heapPop(ProcessHeap *heap, const PCB processes[]) {
+    if (heap->size == 0) {
+        return -1;
+    }
+    int top = heap->items[0];
+    int last = heap->items[--heap->size];
+    int pos = 0;
+    while (1) {
+        int child = pos * 2 + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heap->before(processes, heap->items[child + 1], heap->items[child])) {
+            child++;
+        }
+        if (!heap->before(processes, heap->items[child], last)) {
+            break;
+        }
+        heap->items[pos] = heap->items[child];
+        pos = child;
+    }
+    if (heap->size > 0) {
+        heap->items[pos] = last;
+    }
+    return top;
+}
+
+// 运行队列：可扩容的环形缓冲区，容量只随同时在队列中的进程数增长，
+// 与进程被轮转的次数无关
+typedef struct {
+    int *items;    // 环形数组，存放进程下标
+    int head;      // 队首位置
+    int count;     // 队列中的进程数
+    int capacity;  // 数组容量（2 的幂）
+} RunQueue;
+
+void runQueueInit(RunQueue *q) {
+    q->capacity = 16;
+    q->head = 0;
+    q->count = 0;
+    q->items = (int *)malloc(sizeof(int) * q->capacity);
+    if (q->items == NULL) {
+        perror("Failed to allocate run queue");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void runQueueFree(RunQueue *q) {
+    free(q->items);
+    q->items = NULL;
+    q->count = q->capacity = 0;
+}
+
+// 函数：进程下标放入队尾，队列满时容量翻倍
+void runQueuePush(RunQueue *q, int idx) {
+    if (q->count == q->capacity) {
+        int *items = (int *)malloc(sizeof(int) * q->capacity * 2);
+        if (items == NULL) {
+            perror("Failed to grow run queue");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < q->count; i++) { // 按队列顺序搬到新数组开头
+            items[i] = q->items[(q->head + i) & (q->capacity - 1)];
+        }
+        free(q->items);
+        q->items = items;
+        q->head = 0;
+        q->capacity *= 2;
+    }
+    q->items[(q->head + q->count) & (q->capacity - 1)] = idx;
+    q->count++;
+}
+
+// 函数：取出队首进程下标，队列为空时返回 -1
+int runQueuePop(RunQueue *q) {
+    if (q->count == 0) {
+        return -1;
+    }
+    int idx = q->items[q->head];
+    q->head = (q->head + 1) & (q->capacity - 1);
+    q->count--;
+    return idx;
+}
+
+// 函数：比较两个进程在 current_time 时的响应比，a 更高（相同时序号更小）返回非零
+// 等待时间从进程最近一次进入就绪状态算起，只有一个 CPU 区间时即从到达时间算起
+// 用整数交叉相乘代替浮点除法：(w_a + b_a) / b_a > (w_b + b_b) / b_b
+int higherResponseRatio(const PCB processes[], int a, int b, int current_time) {
+    long long lhs = (long long)(current_time - processes[a].ready_time + processes[a].burst_time) * processes[b].burst_time;
+    long long rhs = (long long)(current_time - processes[b].ready_time + processes[b].burst_time) * processes[a].burst_time;
+    if (lhs != rhs) {
+        return lhs > rhs;
+    }
+    return processes[a].pid < processes[b].pid;
+}
+
+// --- HRRF 就绪集合：动力学锦标赛树 ---
+// 进程 i 在时刻 t 的响应比为 1 + (t - r_i) / b_i（r_i 为进入就绪状态的时间），是 t 的一次函数（斜率 1/b_i）。
+// 用完全二叉树组织就绪进程：每个内部节点记录子树中当前响应比最高的进程（胜者），
+// 以及两个子节点的胜者何时发生交替（证书失效时间）。时钟推进时只重新比较
+// 证书已失效的节点，插入和删除只更新一条到根的路径，每次调度为多对数时间。
+// 比较全部使用整数运算，结果与逐个计算响应比完全一致。
+#define KINETIC_NEVER 0x7FFFFFFFFFFFFFFFLL // 证书永不失效
+
+typedef struct {
+    int *winner;          // 每个节点的胜者进程下标，-1 表示子树为空（节点 1 为根，叶子从 num_leaves 开始）
+    long long *cert;      // 本节点证书失效时间：落败的子节点胜者最早在何时反超
+    long long *expire;    // 子树内最早的证书失效时间
+    int num_leaves;       // 叶子数（2 的幂）
+    int *free_leaves;     // 空闲叶子栈
+    int num_free;
+    int *leaf_of;         // 进程下标 -> 所在叶子，-1 表示不在树中
+    int leaf_of_capacity;
+    long long now;        // 树中胜者对应的时刻
+    int count;            // 就绪进程数
+} KineticTree;
+
+long long floorDiv(long long a, long long b) { // b > 0
+    long long q = a / b;
+    if (a % b != 0 && a < 0) {
+        q--;
+    }
+    return q;
+}
+
+// 函数：胜者 w 在 now 时刻不低于 l，计算 l 最早在哪个时刻反超 w
+// 比较 (t - r_l + b_l) * b_w 与 (t - r_w + b_w) * b_l，差值为 k*t - c
+long long overtakeTime(const PCB processes[], int w, int l) {
+    long long k = (long long)processes[w].burst_time - processes[l].burst_time;
+    if (k <= 0) {
+        return KINETIC_NEVER; // l 的斜率不大于 w，永远无法反超
+    }
+    long long c = (long long)processes[l].ready_time * processes[w].burst_time -
+                  (long long)processes[w].ready_time * processes[l].burst_time;
+    if (processes[l].pid < processes[w].pid) {
+        return -floorDiv(-c, k); // 响应比相等即可胜出：最小的 t 使 k*t >= c
+    }
+    return floorDiv(c, k) + 1;    // 需要严格更高：最小的 t 使 k*t > c
+}
+
+void kineticInit(KineticTree *kt) {
+    kt->num_leaves = 0;
+    kt->winner = NULL;
+    kt->cert = kt->expire = NULL;
+    kt->free_leaves = NULL;
+    kt->num_free = 0;
+    kt->leaf_of = NULL;
+    kt->leaf_of_capacity = 0;
+    kt->now = 0;
+    kt->count = 0;
+}
+
+void kineticFree(KineticTree *kt) {
+    free(kt->winner);
+    free(kt->cert);
+    free(kt->expire);
+    free(kt->free_leaves);
+    free(kt->leaf_of);
+}
+
+// 函数：根据两个子节点重新计算节点的胜者和证书
+void kineticPull(KineticTree *kt, const PCB processes[], int node) {
+    int left = kt->winner[2 * node], right = kt->winner[2 * node + 1];
+    long long expire = kt->expire[2 * node] < kt->expire[2 * node + 1] ? kt->expire[2 * node] : kt->expire[2 * node + 1];
+    if (left == -1 || right == -1) {
+        kt->winner[node] = (left == -1) ? right : left;
+        kt->cert[node] = KINETIC_NEVER;
+    } else {
+        int now = (int)kt->now;
+        int w = higherResponseRatio(processes, left, right, now) ? left : right;
+        int l = (w == left) ? right : left;
+        kt->winner[node] = w;
+        kt->cert[node] = overtakeTime(processes, w, l);
+    }
+    kt->expire[node] = kt->cert[node] < expire ? kt->cert[node] : expire;
+}
+
+// 函数：把时钟推进到 t，重新比较子树中所有证书已失效的节点
+void kineticAdvanceNode(KineticTree *kt, const PCB processes[], int node) {
+    if (kt->expire[node] > kt->now) {
+        return;
+    }
+    if (node < kt->num_leaves) {
+        kineticAdvanceNode(kt, processes, 2 * node);
+        kineticAdvanceNode(kt, processes, 2 * node + 1);
+        kineticPull(kt, processes, node);
+    }
+}
+
+void kineticAdvance(KineticTree *kt, const PCB processes[], int t) {
+    if (t > kt->now) {
+        kt->now = t;
+    }
+    if (kt->num_leaves > 0) {
+        kineticAdvanceNode(kt, processes, 1);
+    }
+}
+
+// 函数：设置叶子上的进程并更新到根的路径
+void kineticSetLeaf(KineticTree *kt, const PCB processes[], int leaf, int idx) {
+    int node = kt->num_leaves + leaf;
+    kt->winner[node] = idx;
+    kt->cert[node] = kt->expire[node] = KINETIC_NEVER;
+    for (node /= 2; node >= 1; node /= 2) {
+        kineticPull(kt, processes, node);
+    }
+}
+
+// 函数：叶子用完时容量翻倍，重建整棵树
+void kineticGrow(KineticTree *kt, const PCB processes[]) {
+    int old_leaves = kt->num_leaves;
+    int *old_winner = kt->winner;
+    kt->num_leaves = old_leaves ? old_leaves * 2 : 16;
+    kt->winner = (int *)checkedRealloc(NULL, sizeof(int) * 2 * kt->num_leaves);
+    kt->cert = (long long *)checkedRealloc(kt->cert, sizeof(long long) * 2 * kt->num_leaves);
+    kt->expire = (long long *)checkedRealloc(kt->expire, sizeof(long long) * 2 * kt->num_leaves);
+    kt->free_leaves = (int *)checkedRealloc(kt->free_leaves, sizeof(int) * kt->num_leaves);
+    for (int node = 0; node < 2 * kt->num_leaves; node++) {
+        kt->winner[node] = -1;
+        kt->cert[node] = kt->expire[node] = KINETIC_NEVER;
+    }
+    for (int leaf = 0; leaf < old_leaves; leaf++) { // 原有进程保持叶子位置不变
+        kt->winner[kt->num_leaves + leaf] = old_winner[old_leaves + leaf];
+    }
+    for (int node = kt->num_leaves - 1; node >= 1; node--) {
+        kineticPull(kt, processes, node);
+    }
+    for (int leaf = kt->num_leaves - 1; leaf >= old_leaves; leaf--) {
+        kt->free_leaves[kt->num_free++] = leaf;
+    }
+    free(old_winner);
+}
+
+// 函数：进程到达后加入锦标赛树
+void kineticPush(KineticTree *kt, const PCB processes[], int idx) {
+    if (idx >= kt->leaf_of_capacity) {
+        int capacity = kt->leaf_of_capacity ? kt->leaf_of_capacity : 16;
+        while (capacity <= idx) {
+            capacity *= 2;
+        }
+        kt->leaf_of = (int *)checkedRealloc(kt->leaf_of, sizeof(int) * capacity);
+        for (int i = kt->leaf_of_capacity; i < capacity; i++) {
+            kt->leaf_of[i] = -1;
+        }
+        kt->leaf_of_capacity = capacity;
+    }
+    if (kt->num_free == 0) {
+        kineticGrow(kt, processes);
+    }
+    int leaf = kt->free_leaves[--kt->num_free];
+    kt->leaf_of[idx] = leaf;
+    kineticSetLeaf(kt, processes, leaf, idx);
+    kt->count++;
+}
+
+// 函数：取出 current_time 时刻响应比最高的进程，集合为空时返回 -1
+int kineticPopHighest(KineticTree *kt, const PCB processes[], int current_time) {
+    if (kt->count == 0) {
+        return -1;
+    }
+    kineticAdvance(kt, processes, current_time);
+    int best = kt->winner[1];
+    int leaf = kt->leaf_of[best];
+    kt->leaf_of[best] = -1;
+    kineticSetLeaf(kt, processes, leaf, -1);
+    kt->free_leaves[kt->num_free++] = leaf;
+    kt->count--;
+    return best;
+}
+
+// --- 随机数生成器 ---
+// 每份工作负载使用独立的生成器状态（splitmix64），不依赖 rand() 的全局状态：
+// 相同种子总是生成相同的进程数据，多个线程同时生成时互不干扰。
+typedef struct {
+    unsigned long long state;
+} Rng;
+
+void rngSeed(Rng *rng, unsigned long long seed) {
+    rng->state = seed;
+}
+
+unsigned long long rngNext(Rng *rng) {
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 函数：返回 [0, n) 之间的随机整数
+int rngBelow(Rng *rng, int n) {
+    return (int)(rngNext(rng) % (unsigned long long)n);
+}
+
+// 函数：用随机数据初始化进程，相同种子生成相同数据
+void initializeProcesses(PCB processes[], int num_processes, unsigned long long seed) {
+    Rng rng;
+    rngSeed(&rng, seed);
 
     processes[0].arrival_time = 0; // 第一个进程在时间 0 到达
     for (int i = 0; i < num_processes; i++) {
         sprintf(processes[i].name, "P%d", i + 1); // 设置进程名，例如 P1, P2
+        processes[i].pid = i;
+        processes[i].priority = 0;
         if (i > 0) {
-            processes[i].arrival_time = rand() % 10; // 其他进程随机到达时间（0-9之间）
+            processes[i].arrival_time = rngBelow(&rng, 10); // 其他进程随机到达时间（0-9之间）
         }
-        processes[i].burst_time = rand() % 15 + 5; // 随机爆发时间（运行时间，5-19之间）
+        processes[i].burst_time = rngBelow(&rng, 15) + 5; // 随机爆发时间（运行时间，5-19之间）
         processes[i].remaining_time = processes[i].burst_time; // 初始剩余时间等于爆发时间
         processes[i].start_time = -1; // 初始开始时间为 -1，表示未开始
         processes[i].finish_time = -1; // 初始完成时间为 -1，表示未完成
         processes[i].turnaround_time = 0; // 初始周转时间为 0
         processes[i].state = 'W'; // 初始状态为等待/就绪
+        processes[i].affinity = -1; // 无亲和性提示
+        processes[i].cpu = -1;
+        processes[i].period = 0;
+        processes[i].deadline = -1; // 无截止时间
+        processes[i].ready_time = processes[i].arrival_time;
+        processes[i].cpu_time = processes[i].burst_time;
+        processes[i].io_time = 0;
+        processes[i].bursts = NULL; // 只有一个 CPU 区间
+        processes[i].num_bursts = 1;
+        processes[i].burst_index = 0;
+        processes[i].queued = 0; // 尚未进入运行队列
     }
 }
 
@@ -87,230 +542,3535 @@ void printStatus(int current_time, PCB processes[], int num_processes, int runni
     }
 }
 
-// 函数：计算平均周转时间
-double calculateAverageTurnaroundTime(PCB processes[], int num_processes) {
-    double total_turnaround_time = 0;
-    for (int i = 0; i < num_processes; i++) {
-        total_turnaround_time += processes[i].turnaround_time; // 累加所有进程的周转时间
+// --- 轨迹文件输入 ---
+// 支持两种格式，按文件头自动识别：
+//   CSV：每行 "进程名,到达时间,运行时间"，可有一行表头，'#' 开头为注释；
+//        运行时间一列也可以是空格分隔的区间序列 "CPU I/O CPU ... CPU"，I/O 区间可写成 "长度@设备号"（默认设备 0）
+//   二进制：8 字节文件头 "PCBTRC01"，随后每条记录 16 字节：
+//           到达时间 (int32 小端) + 运行时间 (int32 小端) + 进程名 (8 字节，不足补 0)
+// 记录必须按到达时间非递减排列，读取时逐条流式解析，不会一次载入整个文件。
+#define TRACE_MAGIC "PCBTRC01"
+#define TRACE_MAGIC_LEN 8
+#define TRACE_RECORD_SIZE 16
+#define TRACE_BUFFER_SIZE (1 << 20) // 文件读缓冲区大小
+#define TRACE_LINE_MAX (1 << 16)    // CSV 一行的最大长度
+
+typedef struct {
+    FILE *fp;
+    int binary;           // 1 为二进制格式，0 为 CSV
+    long long line;       // 当前行号（CSV）或记录号（二进制），用于报错
+    long long count;      // 已读取的记录数
+    int last_arrival;     // 上一条记录的到达时间
+    Burst *bursts;        // 解析区间序列的缓冲区
+    int bursts_capacity;
+    char *line_buffer;    // CSV 行缓冲区
+} TraceReader;
+
+// 函数：打开轨迹文件并识别格式，失败返回 0
+int traceOpen(TraceReader *tr, const char *path) {
+    tr->fp = fopen(path, "rb");
+    if (tr->fp == NULL) {
+        perror(path);
+        return 0;
     }
-    return total_turnaround_time / num_processes; // 返回平均值
+    setvbuf(tr->fp, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+    char magic[TRACE_MAGIC_LEN];
+    size_t got = fread(magic, 1, TRACE_MAGIC_LEN, tr->fp);
+    tr->binary = (got == TRACE_MAGIC_LEN && memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LEN) == 0);
+    if (!tr->binary) {
+        rewind(tr->fp); // CSV 从头解析
+    }
+    tr->line = 0;
+    tr->count = 0;
+    tr->last_arrival = 0;
+    tr->bursts_capacity = 16;
+    tr->bursts = (Burst *)checkedRealloc(NULL, sizeof(Burst) * tr->bursts_capacity);
+    tr->line_buffer = (char *)checkedRealloc(NULL, TRACE_LINE_MAX);
+    return 1;
 }
 
-// --- 短进程优先 (SJF) 调度算法 ---
-void SJF_scheduling(PCB processes[], int num_processes) {
-    printf("\n\n=== 短进程优先 (SJF) 调度 ===\n");
-    // 复制原始进程数据，避免影响其他算法
-    PCB sjf_processes[MAX_PROCESSES];
-    memcpy(sjf_processes, processes, sizeof(PCB) * num_processes);
-
-    int current_time = 0; // 当前时间
-    int completed_processes = 0; // 已完成进程数
-
-    while (completed_processes < num_processes) { // 循环直到所有进程完成
-        int shortest_job_idx = -1; // 最短作业的索引
-        int min_burst_time = 9999; // 最小爆发时间（初始化为一个大值）
-
-        // 查找已到达且处于就绪状态的最短作业
-        for (int i = 0; i < num_processes; i++) {
-            if (sjf_processes[i].state == 'W' && sjf_processes[i].arrival_time <= current_time) {
-                if (sjf_processes[i].burst_time < min_burst_time) {
-                    min_burst_time = sjf_processes[i].burst_time;
-                    shortest_job_idx = i;
+void traceClose(TraceReader *tr) {
+    if (tr->fp != NULL) {
+        fclose(tr->fp);
+        tr->fp = NULL;
+    }
+    free(tr->bursts);
+    free(tr->line_buffer);
+    tr->bursts = NULL;
+    tr->line_buffer = NULL;
+}
+
+// 函数：按一条轨迹记录填写 PCB，有多个区间时复制一份区间序列，由进程完成时释放
+void fillTraceProcess(TraceReader *tr, PCB *p, const char *name, int arrival_time,
+                      const Burst *bursts, int num_bursts, int affinity) {
+    int burst_time = bursts[0].length;
+    if (arrival_time < 0 || burst_time <= 0) {
+        printf("轨迹文件第 %lld 条记录非法：到达时间 %d，运行时间 %d\n", tr->line, arrival_time, burst_time);
+        exit(EXIT_FAILURE);
+    }
+    long long cpu_time = 0, io_time = 0;
+    for (int k = 0; k < num_bursts; k++) {
+        if (bursts[k].length <= 0) {
+            printf("轨迹文件第 %lld 条记录的第 %d 个区间长度 %d 非法\n", tr->line, k + 1, bursts[k].length);
+            exit(EXIT_FAILURE);
+        }
+        if (k % 2 == 0) {
+            cpu_time += bursts[k].length;
+        } else {
+            io_time += bursts[k].length;
+        }
+    }
+    if (cpu_time > INT_MAX || io_time > INT_MAX) {
+        printf("轨迹文件第 %lld 条记录的区间总长超出范围\n", tr->line);
+        exit(EXIT_FAILURE);
+    }
+    if (arrival_time < tr->last_arrival) {
+        printf("轨迹文件第 %lld 条记录的到达时间 %d 早于上一条记录 %d，轨迹须按到达时间排序\n",
+               tr->line, arrival_time, tr->last_arrival);
+        exit(EXIT_FAILURE);
+    }
+    tr->last_arrival = arrival_time;
+    tr->count++;
+
+    if (name[0] != '\0') {
+        snprintf(p->name, sizeof(p->name), "%s", name);
+    } else {
+        snprintf(p->name, sizeof(p->name), "P%u", (unsigned int)(tr->count % 100000000)); // 未给出进程名时按序号命名
+    }
+    p->pid = (int)(tr->count - 1);
+    p->priority = 0;
+    p->arrival_time = arrival_time;
+    p->burst_time = burst_time;
+    p->remaining_time = burst_time;
+    p->start_time = -1;
+    p->finish_time = -1;
+    p->turnaround_time = 0;
+    p->state = 'W';
+    p->queued = 0;
+    p->affinity = affinity;
+    p->cpu = -1;
+    p->period = 0;
+    p->deadline = -1;
+    p->ready_time = arrival_time;
+    p->cpu_time = (int)cpu_time;
+    p->io_time = (int)io_time;
+    p->bursts = NULL;
+    if (num_bursts > 1) {
+        p->bursts = (Burst *)checkedRealloc(NULL, sizeof(Burst) * num_bursts);
+        memcpy(p->bursts, bursts, sizeof(Burst) * num_bursts);
+    }
+    p->num_bursts = num_bursts;
+    p->burst_index = 0;
+}
+
+// 函数：解析 CSV 的区间序列，s 指向序列开头，返回后指向序列之后的字符；返回区间数，格式错误返回 0
+int traceParseBursts(TraceReader *tr, const char **s) {
+    const char *c = *s;
+    int count = 0;
+    while (1) {
+        while (*c == ' ' || *c == '\t') {
+            c++;
+        }
+        if (*c == ',' || *c == '\n' || *c == '\r' || *c == '\0') {
+            break;
+        }
+        char *end;
+        long length = strtol(c, &end, 10);
+        if (end == c || length > INT_MAX || length < INT_MIN) {
+            return 0;
+        }
+        c = end;
+        int device = -1;
+        if (count % 2 == 1) { // I/O 区间
+            device = 0;
+            if (*c == '@') {
+                long d = strtol(c + 1, &end, 10);
+                if (end == c + 1 || d < 0 || d > 65535) {
+                    return 0;
                 }
+                device = (int)d;
+                c = end;
             }
         }
+        if (count == tr->bursts_capacity) {
+            tr->bursts_capacity *= 2;
+            tr->bursts = (Burst *)checkedRealloc(tr->bursts, sizeof(Burst) * tr->bursts_capacity);
+        }
+        tr->bursts[count].length = (int)length;
+        tr->bursts[count].device = device;
+        count++;
+    }
+    *s = c;
+    return count % 2 == 1 ? count : 0; // 必须以 CPU 区间结束
+}
+
+// 函数：读取下一条记录，读完返回 0
+int traceNext(TraceReader *tr, PCB *p) {
+    if (tr->binary) {
+        unsigned char rec[TRACE_RECORD_SIZE];
+        size_t got = fread(rec, 1, TRACE_RECORD_SIZE, tr->fp);
+        if (got == 0) {
+            return 0;
+        }
+        tr->line++;
+        if (got != TRACE_RECORD_SIZE) {
+            printf("轨迹文件第 %lld 条记录不完整\n", tr->line);
+            exit(EXIT_FAILURE);
+        }
+        int arrival_time = (int)((unsigned int)rec[0] | (unsigned int)rec[1] << 8 |
+                                 (unsigned int)rec[2] << 16 | (unsigned int)rec[3] << 24);
+        int burst_time = (int)((unsigned int)rec[4] | (unsigned int)rec[5] << 8 |
+                               (unsigned int)rec[6] << 16 | (unsigned int)rec[7] << 24);
+        char name[9];
+        memcpy(name, rec + 8, 8);
+        name[8] = '\0';
+        Burst burst = {burst_time, -1};
+        fillTraceProcess(tr, p, name, arrival_time, &burst, 1, -1);
+        return 1;
+    }
 
-        if (shortest_job_idx != -1) { // 如果找到了最短作业
-            sjf_processes[shortest_job_idx].state = 'R'; // 设置为运行状态
-            if (sjf_processes[shortest_job_idx].start_time == -1) {
-                sjf_processes[shortest_job_idx].start_time = current_time; // 记录开始时间
+    char *line = tr->line_buffer;
+    while (fgets(line, TRACE_LINE_MAX, tr->fp) != NULL) {
+        tr->line++;
+        if (strchr(line, '\n') == NULL && !feof(tr->fp)) {
+            printf("轨迹文件第 %lld 行超过 %d 个字符\n", tr->line, TRACE_LINE_MAX - 1);
+            exit(EXIT_FAILURE);
+        }
+        char *s = line;
+        while (*s == ' ' || *s == '\t') {
+            s++;
+        }
+        if (*s == '#' || *s == '\n' || *s == '\r' || *s == '\0') {
+            continue; // 跳过注释和空行
+        }
+        char name[64] = "";
+        int arrival_time, affinity = -1; // 可选的第四列为 CPU 亲和性提示
+        int bursts_offset = 0;           // 区间序列在行中的位置
+        if (*s == ',') {
+            sscanf(s, ",%d,%n", &arrival_time, &bursts_offset);
+        } else {
+            sscanf(s, "%63[^,],%d,%n", name, &arrival_time, &bursts_offset);
+        }
+        const char *rest = s + bursts_offset;
+        int num_bursts = bursts_offset > 0 ? traceParseBursts(tr, &rest) : 0;
+        if (num_bursts == 0 || (*rest == ',' && sscanf(rest, ",%d", &affinity) != 1)) {
+            if (tr->count == 0 && tr->line == 1) {
+                continue; // 第一行为表头
             }
+            printf("轨迹文件第 %lld 行格式错误: %s", tr->line, line);
+            exit(EXIT_FAILURE);
+        }
+        fillTraceProcess(tr, p, name, arrival_time, tr->bursts, num_bursts, affinity);
+        return 1;
+    }
+    return 0;
+}
 
-            printStatus(current_time, sjf_processes, num_processes, shortest_job_idx); // 打印当前状态
+// --- 周期任务集 ---
+// 任务文件每行 "任务名,周期,执行时间[,相对截止时间[,首次释放时间]]"，可有一行表头，'#' 开头为注释；
+// 相对截止时间省略时等于周期，首次释放时间省略时为 0。每个任务从首次释放时间起每个周期释放一个作业，
+// 作业作为一个 PCB 到达，绝对截止时间为释放时间加相对截止时间。
+// 作业在模拟过程中按释放时间惰性生成：释放器只为每个任务保存下一次释放时间，
+// 超周期很长、作业数以百万计时，内存也只与任务数和同时存活的作业数有关。
+#define TASK_DEFAULT_HORIZON 10000000 // 超周期超过此值时默认只模拟到此时刻
+#define TASK_MAX_HORIZON (INT_MAX / 2) // 模拟时长上限，保证时间不溢出 int
 
-            // 进程运行到完成（SJF是不可抢占的）
-            current_time += sjf_processes[shortest_job_idx].remaining_time;
-            sjf_processes[shortest_job_idx].remaining_time = 0; // 剩余时间归零
-            sjf_processes[shortest_job_idx].state = 'F'; // 设置为完成状态
-            sjf_processes[shortest_job_idx].finish_time = current_time; // 记录完成时间
-            sjf_processes[shortest_job_idx].turnaround_time =
-                sjf_processes[shortest_job_idx].finish_time - sjf_processes[shortest_job_idx].arrival_time; // 计算周转时间
+typedef struct {
+    char name[10];  // 任务名，也是其作业的进程名
+    int period;     // 周期
+    int wcet;       // 每个作业的执行时间
+    int deadline;   // 相对截止时间
+    int offset;     // 首次释放时间
+} PeriodicTask;
 
-            completed_processes++; // 完成进程数加一
-        } else {
-            current_time++; // 如果没有进程就绪，时间前进
-        }
+typedef struct {
+    PeriodicTask *tasks;
+    int count;
+    int horizon;            // 只释放早于此时刻的作业
+    long long hyperperiod;  // 超周期（各周期的最小公倍数），超出 long long 范围时为 -1
+    long long jobs;         // 模拟时长内释放的作业总数
+} TaskSet;
+
+long long gcdLL(long long a, long long b) {
+    while (b != 0) {
+        long long t = a % b;
+        a = b;
+        b = t;
     }
-    printStatus(current_time, sjf_processes, num_processes, -1); // 打印最终状态
-    printf("\nSJF 平均周转时间: %.2f\n", calculateAverageTurnaroundTime(sjf_processes, num_processes));
+    return a;
 }
 
-// --- 时间片轮转 (RR) 调度算法 ---
-void RR_scheduling(PCB processes[], int num_processes) {
-    printf("\n\n=== 时间片轮转 (RR) 调度 (时间片: %d) ===\n", TIME_SLICE);
-    // 复制原始进程数据
-    PCB rr_processes[MAX_PROCESSES];
-    memcpy(rr_processes, processes, sizeof(PCB) * num_processes);
-
-    int current_time = 0; // 当前时间
-    int completed_processes = 0; // 已完成进程数
-    int queue[MAX_PROCESSES]; // RR 的就绪队列
-    int front = 0, rear = -1; // 队列的头和尾指针
-
-    // 将时间 0 到达的进程加入队列
-    for (int i = 0; i < num_processes; i++) {
-        if (rr_processes[i].arrival_time == 0) {
-            rear++;
-            queue[rear] = i;
+// 函数：读取任务文件，horizon 为 0 时取首次释放时间加超周期（不超过 TASK_DEFAULT_HORIZON），失败返回 0
+int loadTaskSet(TaskSet *ts, const char *path, int horizon) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return 0;
+    }
+    int capacity = 16;
+    ts->tasks = (PeriodicTask *)checkedRealloc(NULL, sizeof(PeriodicTask) * capacity);
+    ts->count = 0;
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_no++;
+        char *s = line;
+        while (*s == ' ' || *s == '\t') {
+            s++;
+        }
+        if (*s == '#' || *s == '\n' || *s == '\r' || *s == '\0') {
+            continue; // 跳过注释和空行
+        }
+        char name[64];
+        int period, wcet, deadline = -1, offset = 0;
+        int fields = sscanf(s, "%63[^,],%d,%d,%d,%d", name, &period, &wcet, &deadline, &offset);
+        if (fields < 3) {
+            if (ts->count == 0 && line_no == 1) {
+                continue; // 第一行为表头
+            }
+            printf("任务文件第 %d 行格式错误: %s", line_no, line);
+            fclose(fp);
+            return 0;
+        }
+        if (fields < 4) {
+            deadline = period; // 隐式截止时间
+        }
+        if (period <= 0 || wcet <= 0 || deadline <= 0 || offset < 0) {
+            printf("任务文件第 %d 行参数非法：周期 %d，执行时间 %d，截止时间 %d，首次释放时间 %d\n",
+                   line_no, period, wcet, deadline, offset);
+            fclose(fp);
+            return 0;
+        }
+        if (ts->count == capacity) {
+            capacity *= 2;
+            ts->tasks = (PeriodicTask *)checkedRealloc(ts->tasks, sizeof(PeriodicTask) * capacity);
         }
+        PeriodicTask *t = &ts->tasks[ts->count++];
+        snprintf(t->name, sizeof(t->name), "%.9s", name);
+        t->period = period;
+        t->wcet = wcet;
+        t->deadline = deadline;
+        t->offset = offset;
+    }
+    fclose(fp);
+    if (ts->count == 0) {
+        printf("任务文件 %s 中没有任务\n", path);
+        return 0;
     }
 
-    while (completed_processes < num_processes) { // 循环直到所有进程完成
-        int running_process_idx = -1;
-        if (front <= rear) { // 如果队列不为空
-            running_process_idx = queue[front]; // 取出队列头部的进程
-            front++; // 队列头部指针后移
+    long long max_offset = 0;
+    ts->hyperperiod = 1;
+    for (int i = 0; i < ts->count; i++) {
+        long long period = ts->tasks[i].period;
+        max_offset = ts->tasks[i].offset > max_offset ? ts->tasks[i].offset : max_offset;
+        if (ts->hyperperiod > 0) {
+            long long step = period / gcdLL(ts->hyperperiod, period);
+            ts->hyperperiod = ts->hyperperiod > LLONG_MAX / step ? -1 : ts->hyperperiod * step; // 溢出记为 -1
         }
+    }
+    if (horizon <= 0) {
+        horizon = (ts->hyperperiod > 0 && ts->hyperperiod <= TASK_DEFAULT_HORIZON - max_offset) ?
+                  (int)(max_offset + ts->hyperperiod) : TASK_DEFAULT_HORIZON;
+    }
+    ts->horizon = horizon;
 
-        if (running_process_idx != -1) { // 如果有进程可以运行
-            rr_processes[running_process_idx].state = 'R'; // 设置为运行状态
-            if (rr_processes[running_process_idx].start_time == -1) {
-                rr_processes[running_process_idx].start_time = current_time; // 记录开始时间
-            }
-
-            printStatus(current_time, rr_processes, num_processes, running_process_idx); // 打印当前状态
+    // 作业数和总工作量：过载时积压的作业在模拟时长之后才完成，时间仍须在 int 范围内
+    long long work = 0;
+    ts->jobs = 0;
+    for (int i = 0; i < ts->count; i++) {
+        const PeriodicTask *t = &ts->tasks[i];
+        long long jobs = t->offset < horizon ? (horizon - t->offset + t->period - 1) / t->period : 0;
+        ts->jobs += jobs;
+        work += jobs * t->wcet;
+    }
+    if (work > INT_MAX - (long long)horizon) {
+        printf("模拟时长 %d 内的总执行时间 %lld 过大，请用 --horizon 缩短模拟时长\n", horizon, work);
+        return 0;
+    }
+    return 1;
+}
 
-            // 计算本次运行的时间
-            int time_to_run = (rr_processes[running_process_idx].remaining_time > TIME_SLICE) ?
-                              TIME_SLICE : rr_processes[running_process_idx].remaining_time;
+void freeTaskSet(TaskSet *ts) {
+    free(ts->tasks);
+    ts->tasks = NULL;
+    ts->count = 0;
+}
 
-            current_time += time_to_run; // 更新当前时间
-            rr_processes[running_process_idx].remaining_time -= time_to_run; // 更新剩余运行时间
+// 作业释放器：按 (下一次释放时间, 任务序号) 排序的任务最小堆
+typedef struct {
+    const TaskSet *set;
+    long long *next_release; // 各任务下一次释放时间
+    int *heap;               // 任务序号
+    int size;
+    long long released;      // 已释放的作业数，作为作业的 pid
+} TaskReleaser;
 
-            // 将在此时间片内到达的新进程添加到就绪队列
-            for (int i = 0; i < num_processes; i++) {
-                if (rr_processes[i].state == 'W' && rr_processes[i].arrival_time > (current_time - time_to_run) && rr_processes[i].arrival_time <= current_time) {
-                    // 检查是否已经在队列中，避免重复添加
-                    int already_in_queue = 0;
-                    for(int q_idx = front; q_idx <= rear; q_idx++) {
-                        if (queue[q_idx] == i) {
-                            already_in_queue = 1;
-                            break;
-                        }
-                    }
-                    if (!already_in_queue) {
-                         rear++;
-                         queue[rear] = i;
-                    }
-                }
-            }
+int releaseBefore(const TaskReleaser *r, int a, int b) {
+    if (r->next_release[a] != r->next_release[b]) {
+        return r->next_release[a] < r->next_release[b];
+    }
+    return a < b;
+}
 
+// 函数：堆顶任务的释放时间变大（或被移除）后下沉
+void releaserSiftDown(TaskReleaser *r, int pos) {
+    int task = r->heap[pos];
+    while (1) {
+        int child = pos * 2 + 1;
+        if (child >= r->size) {
+            break;
+        }
+        if (child + 1 < r->size && releaseBefore(r, r->heap[child + 1], r->heap[child])) {
+            child++;
+        }
+        if (!releaseBefore(r, r->heap[child], task)) {
+            break;
+        }
+        r->heap[pos] = r->heap[child];
+        pos = child;
+    }
+    r->heap[pos] = task;
+}
 
-            if (rr_processes[running_process_idx].remaining_time == 0) { // 如果进程完成
-                rr_processes[running_process_idx].state = 'F'; // 设置为完成状态
-                rr_processes[running_process_idx].finish_time = current_time; // 记录完成时间
-                rr_processes[running_process_idx].turnaround_time =
-                    rr_processes[running_process_idx].finish_time - rr_processes[running_process_idx].arrival_time; // 计算周转时间
-                completed_processes++; // 完成进程数加一
-            } else { // 如果进程未完成，则放回就绪队列尾部
-                rr_processes[running_process_idx].state = 'W'; // 设置为等待/就绪状态
-                rear++; // 队列尾部指针后移
-                queue[rear] = running_process_idx; // 将进程索引放入队列尾部
-            }
-        } else {
-             // 如果就绪队列为空，查找下一个将要到达的进程，并快进时间
-            int next_arrival_time = 99999; // 初始化为一个很大的时间
-            for (int i = 0; i < num_processes; i++) {
-                if (rr_processes[i].state == 'W' && rr_processes[i].arrival_time > current_time && rr_processes[i].arrival_time < next_arrival_time) {
-                    next_arrival_time = rr_processes[i].arrival_time;
-                }
-            }
-            if (next_arrival_time != 99999) { // 如果找到了下一个到达的进程
-                current_time = next_arrival_time; // 时间跳到该进程到达时间
-                 // 将所有在当前时间到达的进程加入队列
-                 for (int i = 0; i < num_processes; i++) {
-                    if (rr_processes[i].state == 'W' && rr_processes[i].arrival_time == current_time) {
-                        rear++;
-                        queue[rear] = i;
-                    }
-                }
-            } else {
-                current_time++; // 没有新进程，时间只前进一单位
-            }
+void releaserInit(TaskReleaser *r, const TaskSet *set) {
+    r->set = set;
+    r->next_release = (long long *)checkedRealloc(NULL, sizeof(long long) * set->count);
+    r->heap = (int *)checkedRealloc(NULL, sizeof(int) * set->count);
+    r->size = 0;
+    r->released = 0;
+    for (int i = 0; i < set->count; i++) {
+        r->next_release[i] = set->tasks[i].offset;
+        if (set->tasks[i].offset < set->horizon) {
+            r->heap[r->size++] = i;
         }
     }
-    printStatus(current_time, rr_processes, num_processes, -1); // 打印最终状态
-    printf("\nRR 平均周转时间: %.2f\n", calculateAverageTurnaroundTime(rr_processes, num_processes));
+    for (int i = r->size / 2 - 1; i >= 0; i--) {
+        releaserSiftDown(r, i);
+    }
 }
 
-// --- 高响应比优先 (HRRF) 调度算法 ---
-void HRRF_scheduling(PCB processes[], int num_processes) {
-    printf("\n\n=== 高响应比优先 (HRRF) 调度 ===\n");
-    // 复制原始进程数据
-    PCB hrrf_processes[MAX_PROCESSES];
-    memcpy(hrrf_processes, processes, sizeof(PCB) * num_processes);
-
-    int current_time = 0; // 当前时间
-    int completed_processes = 0; // 已完成进程数
-
-    while (completed_processes < num_processes) { // 循环直到所有进程完成
-        int hrrf_process_idx = -1; // 具有最高响应比的进程索引
-        double max_response_ratio = -1.0; // 最高响应比（初始化为一个小值）
-
-        // 查找已到达且处于就绪状态的进程中响应比最高的
-        for (int i = 0; i < num_processes; i++) {
-            if (hrrf_processes[i].state == 'W' && hrrf_processes[i].arrival_time <= current_time) {
-                double waiting_time = current_time - hrrf_processes[i].arrival_time; // 等待时间
-                // 响应比 = (等待时间 + 运行时间) / 运行时间
-                double response_ratio = (waiting_time + hrrf_processes[i].burst_time) / hrrf_processes[i].burst_time;
-
-                if (response_ratio > max_response_ratio) { // 如果找到更高的响应比
-                    max_response_ratio = response_ratio;
-                    hrrf_process_idx = i;
-                }
-            }
+void releaserFree(TaskReleaser *r) {
+    free(r->next_release);
+    free(r->heap);
+    r->next_release = NULL;
+    r->heap = NULL;
+}
+
+// 函数：按释放时间顺序生成下一个作业，模拟时长内没有更多作业时返回 0
+int releaserNext(TaskReleaser *r, PCB *p) {
+    if (r->size == 0) {
+        return 0;
+    }
+    int task = r->heap[0];
+    const PeriodicTask *t = &r->set->tasks[task];
+    int release = (int)r->next_release[task];
+
+    memcpy(p->name, t->name, sizeof(p->name));
+    p->pid = (int)r->released++;
+    p->priority = task; // 任务序号，RM 周期相同时的次序
+    p->arrival_time = release;
+    p->burst_time = t->wcet;
+    p->remaining_time = t->wcet;
+    p->start_time = -1;
+    p->finish_time = -1;
+    p->turnaround_time = 0;
+    p->state = 'W';
+    p->queued = 0;
+    p->affinity = -1;
+    p->cpu = -1;
+    p->period = t->period;
+    p->deadline = release + t->deadline;
+    p->ready_time = release;
+    p->cpu_time = t->wcet;
+    p->io_time = 0;
+    p->bursts = NULL;
+    p->num_bursts = 1;
+    p->burst_index = 0;
+
+    r->next_release[task] += t->period;
+    if (r->next_release[task] >= r->set->horizon) {
+        r->heap[0] = r->heap[--r->size]; // 该任务在模拟时长内不再释放作业
+    }
+    if (r->size > 0) {
+        releaserSiftDown(r, 0);
+    }
+    return 1;
+}
+
+// 函数：截止时间不超过 t 的作业的总执行时间（同步释放时的处理器需求）
+long long demandBound(const TaskSet *ts, long long t) {
+    long long demand = 0;
+    for (int i = 0; i < ts->count; i++) {
+        const PeriodicTask *task = &ts->tasks[i];
+        if (t >= task->deadline) {
+            demand += ((t - task->deadline) / task->period + 1) * task->wcet;
         }
+    }
+    return demand;
+}
 
-        if (hrrf_process_idx != -1) { // 如果找到了高响应比进程
-            hrrf_processes[hrrf_process_idx].state = 'R'; // 设置为运行状态
-            if (hrrf_processes[hrrf_process_idx].start_time == -1) {
-                hrrf_processes[hrrf_process_idx].start_time = current_time; // 记录开始时间
-            }
+// 函数：早于 t 的最晚绝对截止时间（同步释放），没有则返回 -1
+long long lastDeadlineBefore(const TaskSet *ts, long long t) {
+    long long latest = -1;
+    for (int i = 0; i < ts->count; i++) {
+        const PeriodicTask *task = &ts->tasks[i];
+        if (t > task->deadline) {
+            long long d = (t - 1 - task->deadline) / task->period * task->period + task->deadline;
+            latest = d > latest ? d : latest;
+        }
+    }
+    return latest;
+}
 
-            printStatus(current_time, hrrf_processes, num_processes, hrrf_process_idx); // 打印当前状态
+// 函数：EDF 可调度性判定。截止时间不小于周期时 U <= 1 即可调度；
+// 否则用快速处理器需求分析 (QPA) 检查 [0, L) 内所有截止时间处的需求，L 为同步忙区间的上界
+// 返回 1 可调度，0 不可调度
+int edfSchedulable(const TaskSet *ts, double utilization) {
+    int implicit = 1;
+    for (int i = 0; i < ts->count; i++) {
+        implicit = implicit && ts->tasks[i].deadline >= ts->tasks[i].period;
+    }
+    if (utilization > 1.0 + 1e-12) {
+        return 0;
+    }
+    if (implicit) {
+        return 1;
+    }
+    // 同步忙区间长度：w = Σ ceil(w / T) * C 的最小不动点
+    long long busy = 0, next = 0;
+    for (int i = 0; i < ts->count; i++) {
+        next += ts->tasks[i].wcet;
+    }
+    while (next != busy) {
+        busy = next;
+        next = 0;
+        for (int i = 0; i < ts->count; i++) {
+            next += (busy + ts->tasks[i].period - 1) / ts->tasks[i].period * ts->tasks[i].wcet;
+        }
+        if (next > LLONG_MAX / 4) {
+            return 0; // U = 1 且忙区间无界
+        }
+    }
+    long long d_min = LLONG_MAX;
+    for (int i = 0; i < ts->count; i++) {
+        d_min = ts->tasks[i].deadline < d_min ? ts->tasks[i].deadline : d_min;
+    }
+    long long t = lastDeadlineBefore(ts, busy + 1);
+    while (t >= d_min) {
+        long long h = demandBound(ts, t);
+        if (h > t) {
+            return 0;
+        }
+        if (h <= d_min) {
+            return 1;
+        }
+        t = h < t ? h : lastDeadlineBefore(ts, t);
+    }
+    return 1;
+}
 
-            // 进程运行到完成（HRRF是不可抢占的）
-            current_time += hrrf_processes[hrrf_process_idx].remaining_time;
-            hrrf_processes[hrrf_process_idx].remaining_time = 0; // 剩余时间归零
-            hrrf_processes[hrrf_process_idx].state = 'F'; // 设置为完成状态
-            hrrf_processes[hrrf_process_idx].finish_time = current_time; // 记录完成时间
-            hrrf_processes[hrrf_process_idx].turnaround_time =
-                hrrf_processes[hrrf_process_idx].finish_time - hrrf_processes[hrrf_process_idx].arrival_time; // 计算周转时间
+// 函数：RM 下任务 i 的最坏响应时间（同步释放，周期短者优先，周期相同时序号小者优先）
+// 截止时间不超过周期时为精确分析；超过截止时间即停止迭代，返回值大于截止时间表示可能错过
+long long rmResponseTime(const TaskSet *ts, int i) {
+    const PeriodicTask *task = &ts->tasks[i];
+    long long response = task->wcet;
+    while (1) {
+        long long next = task->wcet;
+        for (int j = 0; j < ts->count; j++) {
+            const PeriodicTask *hp = &ts->tasks[j];
+            if (hp->period < task->period || (hp->period == task->period && j < i)) {
+                next += (response + hp->period - 1) / hp->period * hp->wcet;
+            }
+        }
+        if (next == response || next > task->deadline) {
+            return next;
+        }
+        response = next;
+    }
+}
 
-            completed_processes++; // 完成进程数加一
+// 函数：输出任务集参数和 EDF、RM 的可调度性分析
+void printTaskSetAnalysis(const TaskSet *ts) {
+    double utilization = 0, density = 0;
+    int constrained = 1;
+    for (int i = 0; i < ts->count; i++) {
+        const PeriodicTask *t = &ts->tasks[i];
+        utilization += (double)t->wcet / t->period;
+        density += (double)t->wcet / (t->deadline < t->period ? t->deadline : t->period);
+        constrained = constrained && t->deadline <= t->period;
+    }
+    printf("周期任务集：%d 个任务，", ts->count);
+    if (ts->hyperperiod > 0) {
+        printf("超周期 %lld，", ts->hyperperiod);
+    } else {
+        printf("超周期超出 long long 范围，");
+    }
+    printf("模拟时长 %d，共释放 %lld 个作业\n", ts->horizon, ts->jobs);
+    printf("%-11s%-12s%-16s%-16s%-22s%s\n", "任务", "周期", "执行时间", "截止时间", "首次释放时间", "RM 最坏响应时间");
+    int rm_ok = 1;
+    for (int i = 0; i < ts->count; i++) {
+        const PeriodicTask *t = &ts->tasks[i];
+        printf("%-9s%-10d%-12d%-12d%-16d", t->name, t->period, t->wcet, t->deadline, t->offset);
+        if (!constrained) {
+            printf("-\n");
+            continue;
+        }
+        long long response = rmResponseTime(ts, i);
+        if (response > t->deadline) {
+            printf("> %d（可能错过截止时间）\n", t->deadline);
+            rm_ok = 0;
         } else {
-            current_time++; // 如果没有进程就绪，时间前进
+            printf("%lld\n", response);
         }
     }
-    printStatus(current_time, hrrf_processes, num_processes, -1); // 打印最终状态
-    printf("\nHRRF 平均周转时间: %.2f\n", calculateAverageTurnaroundTime(hrrf_processes, num_processes));
+    double bound = ts->count * (pow(2.0, 1.0 / ts->count) - 1);
+    printf("总利用率 U = %.4f，密度 = %.4f\n", utilization, density);
+    printf("EDF：%s\n", edfSchedulable(ts, utilization) ? "可调度" : "不可调度");
+    if (constrained) {
+        printf("RM：Liu-Layland 界 %.4f，U %s该界；响应时间分析：%s\n", bound,
+               utilization <= bound ? "不超过" : "超过", rm_ok ? "可调度" : "不可调度");
+    } else {
+        printf("RM：Liu-Layland 界 %.4f，U %s该界；存在截止时间大于周期的任务，不做响应时间分析\n", bound,
+               utilization <= bound ? "不超过" : "超过");
+    }
+    if (ts->hyperperiod <= 0 || ts->hyperperiod > ts->horizon) {
+        printf("注意：模拟时长短于超周期，结果只覆盖超周期的前一段\n");
+    }
 }
 
+// --- 离散事件调度内核 ---
+// 所有调度算法共用同一个事件日历：进程到达、进程完成、时间片到期、I/O 完成。
+// 时钟直接跳到下一个事件发生的时刻，空闲时段不再逐单位推进，
+// 运行代价只与事件数有关，与模拟的时间长度无关。
 
-int main() {
-    PCB processes[MAX_PROCESSES]; // 定义进程数组
+// 事件类型，同一时刻按此顺序处理：先接纳新到达的进程，再处理 CPU 上的事件
+// 进程被抢占后，它原先登记的完成/时间片到期事件凭分派序号识别为过期，取出时忽略
+typedef enum {
+    EVENT_ARRIVAL,     // 进程到达
+    EVENT_IO_COMPLETE, // I/O 请求完成（idx 为设备号），进程回到就绪集合
+    EVENT_COMPLETE,    // 进程（或其当前 CPU 区间）运行完成
+    EVENT_SLICE_END    // 时间片到期
+} EventType;
 
-    // 运行 SJF 调度
-    initializeProcesses(processes, MAX_PROCESSES); // 初始化进程
-    SJF_scheduling(processes, MAX_PROCESSES);      // 执行 SJF 调度
+typedef struct {
+    int time;        // 事件发生时间
+    EventType type;  // 事件类型
+    int idx;         // 相关进程下标
+    int dispatch;    // CPU 事件所属的分派序号
+} Event;
+
+// 事件日历：按 (时间, 类型, 进程下标) 排序的最小堆
+typedef struct {
+    Event *items;
+    int size;
+    int capacity;
+} EventCalendar;
+
+int eventBefore(const Event *a, const Event *b) {
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    if (a->type != b->type) {
+        return a->type < b->type;
+    }
+    return a->idx < b->idx;
+}
+
+void calendarInit(EventCalendar *cal) {
+    cal->capacity = 4;
+    cal->size = 0;
+    cal->items = (Event *)malloc(sizeof(Event) * cal->capacity);
+    if (cal->items == NULL) {
+        perror("Failed to allocate event calendar");
+        exit(EXIT_FAILURE);
+    }
+}
 
-    // 运行 RR 调度
-    initializeProcesses(processes, MAX_PROCESSES); // 重新初始化进程，确保各算法使用相同初始数据
-    RR_scheduling(processes, MAX_PROCESSES);       // 执行 RR 调度
+void calendarFree(EventCalendar *cal) {
+    free(cal->items);
+    cal->items = NULL;
+    cal->size = cal->capacity = 0;
+}
 
-    // 运行 HRRF 调度
-    initializeProcesses(processes, MAX_PROCESSES); // 再次重新初始化进程
-    HRRF_scheduling(processes, MAX_PROCESSES);     // 执行 HRRF 调度
+// 函数：登记一个事件
+void calendarPush(EventCalendar *cal, int time, EventType type, int idx, int dispatch) {
+    if (cal->size == cal->capacity) {
+        cal->capacity *= 2;
+        cal->items = (Event *)realloc(cal->items, sizeof(Event) * cal->capacity);
+        if (cal->items == NULL) {
+            perror("Failed to grow event calendar");
+            exit(EXIT_FAILURE);
+        }
+    }
+    Event ev = {time, type, idx, dispatch};
+    int pos = cal->size++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!eventBefore(&ev, &cal->items[parent])) {
+            break;
+        }
+        cal->items[pos] = cal->items[parent];
+        pos = parent;
+    }
+    cal->items[pos] = ev;
+}
+
+// 函数：取出最早发生的事件
+Event calendarPop(EventCalendar *cal) {
+    Event top = cal->items[0];
+    Event last = cal->items[--cal->size];
+    int pos = 0;
+    while (1) {
+        int child = pos * 2 + 1;
+        if (child >= cal->size) {
+            break;
+        }
+        if (child + 1 < cal->size && eventBefore(&cal->items[child + 1], &cal->items[child])) {
+            child++;
+        }
+        if (!eventBefore(&cal->items[child], &last)) {
+            break;
+        }
+        cal->items[pos] = cal->items[child];
+        pos = child;
+    }
+    if (cal->size > 0) {
+        cal->items[pos] = last;
+    }
+    return top;
+}
+
+// --- 延迟统计 ---
+// 进程完成时在线更新，不需要保留已完成的 PCB。均值按精确的累加和计算；
+// 百分位数用 HDR 直方图：小于 LATENCY_SUB_COUNT 的值逐个计数，更大的值按 2 的幂分段，
+// 每段均分为 LATENCY_HALF_COUNT 个桶，相对误差不超过 1/LATENCY_HALF_COUNT，
+// 桶数只取决于数值的位数，与进程数无关。
+#define LATENCY_SUB_BITS 8
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_HALF_COUNT (LATENCY_SUB_COUNT / 2)
+#define LATENCY_BUCKETS (LATENCY_SUB_COUNT + (63 - LATENCY_SUB_BITS) * LATENCY_HALF_COUNT)
+#define SLOWDOWN_SCALE 100 // 带权周转时间按 1/100 定点记录
+
+typedef struct {
+    long long *counts;  // 各桶计数
+    long long total;    // 记录的值个数
+    double sum;         // 值之和
+    long long max;      // 最大值
+} LatencyHistogram;
+
+typedef struct {
+    LatencyHistogram waiting;     // 等待时间 = 周转时间 - CPU 时间 - I/O 时间
+    LatencyHistogram response;    // 响应时间 = 开始时间 - 到达时间
+    LatencyHistogram turnaround;  // 周转时间 = 完成时间 - 到达时间
+    LatencyHistogram slowdown;    // 带权周转时间 = 周转时间 / (CPU 时间 + I/O 时间)
+    LatencyHistogram tardiness;   // 拖延时间 = max(0, 完成时间 - 截止时间)，只记录有截止时间的作业
+    long long deadline_jobs;      // 有截止时间的已完成作业数
+    long long deadline_misses;    // 完成时间晚于截止时间的作业数
+    double lateness_sum;          // 延迟（完成时间 - 截止时间，提前完成为负）之和
+    long long min_lateness;       // 最小延迟
+    long long max_lateness;       // 最大延迟
+} LatencyStats;
+
+void histogramInit(LatencyHistogram *h) {
+    h->counts = (long long *)calloc(LATENCY_BUCKETS, sizeof(long long));
+    if (h->counts == NULL) {
+        perror("Failed to allocate latency histogram");
+        exit(EXIT_FAILURE);
+    }
+    h->total = 0;
+    h->sum = 0;
+    h->max = 0;
+}
+
+void histogramFree(LatencyHistogram *h) {
+    free(h->counts);
+    h->counts = NULL;
+}
+
+// 函数：非负值所在的桶
+int histogramBucket(long long value) {
+    if (value < LATENCY_SUB_COUNT) {
+        return (int)value;
+    }
+    int shift = (63 - __builtin_clzll((unsigned long long)value)) - (LATENCY_SUB_BITS - 1); // 使 value >> shift 落在 [HALF, SUB)
+    return LATENCY_SUB_COUNT + (shift - 1) * LATENCY_HALF_COUNT + (int)(value >> shift) - LATENCY_HALF_COUNT;
+}
+
+// 函数：桶中的最大值
+long long histogramBucketHigh(int bucket) {
+    if (bucket < LATENCY_SUB_COUNT) {
+        return bucket;
+    }
+    int shift = (bucket - LATENCY_SUB_COUNT) / LATENCY_HALF_COUNT + 1;
+    long long sub = (bucket - LATENCY_SUB_COUNT) % LATENCY_HALF_COUNT + LATENCY_HALF_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+void histogramRecord(LatencyHistogram *h, long long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    h->counts[histogramBucket(value)]++;
+    h->total++;
+    h->sum += (double)value;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+// 函数：百分位数（最近秩法），返回所在桶的最大值，不超过记录到的最大值
+long long histogramPercentile(const LatencyHistogram *h, double p) {
+    if (h->total == 0) {
+        return 0;
+    }
+    long long rank = (long long)(p * h->total + 0.999999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    long long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            long long high = histogramBucketHigh(b);
+            return high < h->max ? high : h->max;
+        }
+    }
+    return h->max;
+}
+
+void latencyInit(LatencyStats *stats) {
+    histogramInit(&stats->waiting);
+    histogramInit(&stats->response);
+    histogramInit(&stats->turnaround);
+    histogramInit(&stats->slowdown);
+    histogramInit(&stats->tardiness);
+    stats->deadline_jobs = 0;
+    stats->deadline_misses = 0;
+    stats->lateness_sum = 0;
+    stats->min_lateness = LLONG_MAX;
+    stats->max_lateness = LLONG_MIN;
+}
+
+void latencyFree(LatencyStats *stats) {
+    histogramFree(&stats->waiting);
+    histogramFree(&stats->response);
+    histogramFree(&stats->turnaround);
+    histogramFree(&stats->slowdown);
+    histogramFree(&stats->tardiness);
+}
+
+// 函数：记录一个已完成进程的各项延迟
+void latencyRecord(LatencyStats *stats, const PCB *p) {
+    histogramRecord(&stats->waiting, p->turnaround_time - p->cpu_time - p->io_time);
+    histogramRecord(&stats->response, p->start_time - p->arrival_time);
+    histogramRecord(&stats->turnaround, p->turnaround_time);
+    long long service = (long long)p->cpu_time + p->io_time;
+    histogramRecord(&stats->slowdown, ((long long)p->turnaround_time * SLOWDOWN_SCALE + service / 2) / service);
+    if (p->deadline >= 0) {
+        long long lateness = (long long)p->finish_time - p->deadline;
+        stats->deadline_jobs++;
+        stats->deadline_misses += lateness > 0;
+        stats->lateness_sum += (double)lateness;
+        stats->min_lateness = lateness < stats->min_lateness ? lateness : stats->min_lateness;
+        stats->max_lateness = lateness > stats->max_lateness ? lateness : stats->max_lateness;
+        histogramRecord(&stats->tardiness, lateness); // 提前完成的拖延时间为 0
+    }
+}
+
+// 函数：输出一行统计：均值、p50、p90、p99、p99.9 和最大值
+void printHistogramRow(const char *label, const LatencyHistogram *h, int scale) {
+    static const double points[] = {0.50, 0.90, 0.99, 0.999};
+    printf("%s", label);
+    printf("%14.2f", h->total ? h->sum / h->total / scale : 0.0);
+    for (int i = 0; i < 4; i++) {
+        printf("%14.2f", (double)histogramPercentile(h, points[i]) / scale);
+    }
+    printf("%14.2f\n", (double)h->max / scale);
+}
+
+void printLatencyStats(const LatencyStats *stats) {
+    printf("%-18s%16s%14s%14s%14s%14s%16s\n", "指标", "平均", "p50", "p90", "p99", "p99.9", "最大");
+    printHistogramRow("等待时间        ", &stats->waiting, 1);
+    printHistogramRow("响应时间        ", &stats->response, 1);
+    printHistogramRow("周转时间        ", &stats->turnaround, 1);
+    printHistogramRow("带权周转时间    ", &stats->slowdown, SLOWDOWN_SCALE);
+    if (stats->deadline_jobs > 0) {
+        printHistogramRow("拖延时间        ", &stats->tardiness, 1);
+        printf("截止时间：%lld 个作业错过 %lld 个（错失率 %.4f%%），延迟平均 %.2f，最小 %lld，最大 %lld\n",
+               stats->deadline_jobs, stats->deadline_misses, 100.0 * stats->deadline_misses / stats->deadline_jobs,
+               stats->lateness_sum / stats->deadline_jobs, stats->min_lateness, stats->max_lateness);
+    }
+}
+
+// I/O 设备：一次服务一个请求，其余请求在设备等待队列中先来先服务。
+// 设备按轨迹中出现的设备号按需创建。
+typedef struct {
+    RunQueue waiting;    // 等待队列
+    int busy;            // 正在服务的进程，-1 表示空闲
+    int finish_time;     // 当前请求完成的时间
+    long long busy_time; // 累计服务时间
+    long long requests;  // 完成的请求数
+} IoDevice;
+
+// 一次调度模拟的进程来源与结果
+// 预加载模式：进程表包含全部进程，按到达流依次到达，结束后可打印完整 PCB 表。
+// 流式模式：从轨迹文件逐条读取（或由周期任务集按释放时间生成作业），进程到达时才占用进程槽，
+//           完成后槽被复用，进程表大小只与同时存活的进程数有关，与轨迹长度无关。
+typedef struct {
+    PCB *processes;            // 进程表（流式模式下为进程槽）
+    int num_processes;         // 进程表中已使用的项数
+    int capacity;              // 进程表容量
+    ArrivalEntry *arrivals;    // 预加载模式的到达流
+    int next_arrival;          // 到达流游标
+    TraceReader trace;         // 流式模式的轨迹读取器
+    const TaskSet *task_set;   // 周期任务集（非 NULL 时流式模式的进程为其作业）
+    TaskReleaser releaser;     // 周期任务集的作业释放器
+    int streaming;             // 是否为流式模式
+    int *free_slots;           // 流式模式下可复用的进程槽
+    int num_free;
+    int time_slice;            // 时间片大小（RR 以及 MLFQ 最高级队列使用）
+    int switch_cost;           // 每次上下文切换的开销（时间单位），切换期间 CPU 不运行任何进程
+    int verbosity;             // 输出详细程度
+    int current_time;          // 当前时间（模拟结束后为最后一个进程完成的时间）
+    long long completed;       // 已完成进程数
+    long long dispatches;      // 分派次数（进程被放上 CPU 的次数）
+    long long context_switches; // 上下文切换次数（分派的进程与 CPU 上一个运行的进程不同）
+    long long switch_time;     // 上下文切换占用的 CPU 时间
+    long long busy_time;       // 进程实际运行的 CPU 时间
+    IoDevice *devices;         // I/O 设备
+    int num_devices;
+    LatencyStats latency;      // 已完成进程的延迟统计
+} Simulation;
+
+// 工作负载：三种进程来源之一，每次模拟都从它重新初始化
+typedef struct {
+    PCB *processes;           // 预先生成的进程
+    int num_processes;
+    const char *trace_path;   // 轨迹文件，非 NULL 时使用
+    const TaskSet *task_set;  // 周期任务集，非 NULL 时优先使用
+} Workload;
+
+// 命令行指定的模拟参数，运行各算法前应用到每个模拟上
+typedef struct {
+    int verbosity;     // 输出详细程度
+    int time_slice;    // 时间片大小
+    int switch_cost;   // 上下文切换开销
+} SimOptions;
+
+void simApplyOptions(Simulation *sim, const SimOptions *options) {
+    sim->verbosity = options->verbosity;
+    sim->time_slice = options->time_slice;
+    sim->switch_cost = options->switch_cost;
+}
+
+// 函数：用预先生成的进程初始化模拟（复制一份，避免影响其他算法）
+void simInitProcesses(Simulation *sim, PCB processes[], int num_processes) {
+    memset(sim, 0, sizeof(*sim));
+    sim->time_slice = TIME_SLICE;
+    sim->verbosity = VERBOSITY_RESULT;
+    sim->processes = copyProcesses(processes, num_processes);
+    sim->num_processes = sim->capacity = num_processes;
+    sim->arrivals = buildArrivalStream(sim->processes, num_processes);
+    latencyInit(&sim->latency);
+}
+
+// 函数：用轨迹文件初始化流式模拟，失败返回 0
+int simInitTrace(Simulation *sim, const char *path) {
+    memset(sim, 0, sizeof(*sim));
+    sim->time_slice = TIME_SLICE;
+    sim->verbosity = VERBOSITY_RESULT;
+    if (!traceOpen(&sim->trace, path)) {
+        return 0;
+    }
+    sim->streaming = 1;
+    sim->capacity = 16;
+    sim->processes = (PCB *)checkedRealloc(NULL, sizeof(PCB) * sim->capacity);
+    sim->free_slots = (int *)checkedRealloc(NULL, sizeof(int) * sim->capacity);
+    latencyInit(&sim->latency);
+    return 1;
+}
+
+// 函数：用周期任务集初始化流式模拟，作业在模拟过程中按释放时间生成
+void simInitTasks(Simulation *sim, const TaskSet *task_set) {
+    memset(sim, 0, sizeof(*sim));
+    sim->time_slice = TIME_SLICE;
+    sim->verbosity = VERBOSITY_RESULT;
+    sim->task_set = task_set;
+    releaserInit(&sim->releaser, task_set);
+    sim->streaming = 1;
+    sim->capacity = 16;
+    sim->processes = (PCB *)checkedRealloc(NULL, sizeof(PCB) * sim->capacity);
+    sim->free_slots = (int *)checkedRealloc(NULL, sizeof(int) * sim->capacity);
+    latencyInit(&sim->latency);
+}
+
+void simFree(Simulation *sim) {
+    if (sim->task_set != NULL) {
+        releaserFree(&sim->releaser);
+    } else if (sim->streaming) {
+        traceClose(&sim->trace);
+    }
+    free(sim->processes);
+    free(sim->arrivals);
+    free(sim->free_slots);
+    for (int d = 0; d < sim->num_devices; d++) {
+        runQueueFree(&sim->devices[d].waiting);
+    }
+    free(sim->devices);
+    latencyFree(&sim->latency);
+}
+
+// 函数：进程完成后更新统计，流式模式下归还进程槽
+void simRecordCompletion(Simulation *sim, int idx) {
+    sim->completed++; // 完成进程数加一
+    latencyRecord(&sim->latency, &sim->processes[idx]);
+    if (sim->streaming) {
+        free(sim->processes[idx].bursts); // 区间序列归流式模拟所有
+        sim->processes[idx].bursts = NULL;
+        sim->free_slots[sim->num_free++] = idx; // 归还进程槽
+    }
+}
+
+// 函数：取得下一个到达的进程下标，没有更多进程时返回 -1
+int simNextArrival(Simulation *sim) {
+    if (!sim->streaming) {
+        if (sim->next_arrival >= sim->num_processes) {
+            return -1;
+        }
+        return sim->arrivals[sim->next_arrival++].idx;
+    }
+    PCB record;
+    if (sim->task_set != NULL ? !releaserNext(&sim->releaser, &record) : !traceNext(&sim->trace, &record)) {
+        return -1;
+    }
+    int slot;
+    if (sim->num_free > 0) {
+        slot = sim->free_slots[--sim->num_free]; // 复用已完成进程的槽
+    } else {
+        if (sim->num_processes == sim->capacity) {
+            sim->capacity *= 2;
+            sim->processes = (PCB *)checkedRealloc(sim->processes, sizeof(PCB) * sim->capacity);
+            sim->free_slots = (int *)checkedRealloc(sim->free_slots, sizeof(int) * sim->capacity);
+        }
+        slot = sim->num_processes++;
+    }
+    sim->processes[slot] = record;
+    return slot;
+}
+
+// 函数：设备 d 开始服务进程 idx 的当前 I/O 区间
+void ioServe(Simulation *sim, int d, int idx) {
+    IoDevice *dev = &sim->devices[d];
+    const PCB *p = &sim->processes[idx];
+    dev->busy = idx;
+    dev->finish_time = sim->current_time + p->bursts[p->burst_index].length;
+}
+
+// 函数：进程的 CPU 区间结束，转入下一个 I/O 区间：设备空闲则立即开始服务，否则在设备队列中等待
+// 返回开始服务的设备号（调用者登记其完成时间），排队等待时返回 -1
+int simStartIo(Simulation *sim, int idx) {
+    PCB *p = &sim->processes[idx];
+    p->burst_index++;
+    int d = p->bursts[p->burst_index].device;
+    if (d >= sim->num_devices) { // 按需创建设备
+        sim->devices = (IoDevice *)checkedRealloc(sim->devices, sizeof(IoDevice) * (d + 1));
+        for (int k = sim->num_devices; k <= d; k++) {
+            runQueueInit(&sim->devices[k].waiting);
+            sim->devices[k].busy = -1;
+            sim->devices[k].finish_time = 0;
+            sim->devices[k].busy_time = 0;
+            sim->devices[k].requests = 0;
+        }
+        sim->num_devices = d + 1;
+    }
+    if (sim->devices[d].busy != -1) {
+        runQueuePush(&sim->devices[d].waiting, idx);
+        return -1;
+    }
+    ioServe(sim, d, idx);
+    return d;
+}
+
+// 函数：设备 d 完成当前请求，进程转入下一个 CPU 区间并变为就绪，返回该进程；
+// 设备接着服务等待队列中的下一个请求（调用者检查 busy 登记其完成时间）
+int simFinishIo(Simulation *sim, int d) {
+    IoDevice *dev = &sim->devices[d];
+    int idx = dev->busy;
+    PCB *p = &sim->processes[idx];
+    dev->busy_time += p->bursts[p->burst_index].length;
+    dev->requests++;
+    p->burst_index++;
+    p->burst_time = p->bursts[p->burst_index].length;
+    p->remaining_time = p->burst_time;
+    p->state = 'W';
+    p->ready_time = sim->current_time;
+    dev->busy = -1;
+    int next = runQueuePop(&dev->waiting);
+    if (next != -1) {
+        ioServe(sim, d, next);
+    }
+    return idx;
+}
+
+// --- 调度策略接口 ---
+// 每种调度算法实现一组就绪集合操作，由同一个事件内核驱动。
+// 进程表在流式输入时可能扩容搬移，因此每次调用都传入当前的进程表。
+// 标为“可选”的操作可以为 NULL。
+typedef struct {
+    const char *name;        // 算法简称，用于结果输出
+    const char *title;       // 算法全称
+    int uses_time_slice;     // 是否使用 Simulation 的时间片参数
+    void* (*create)(const Simulation *sim);                      // 创建就绪集合
+    void (*destroy)(void *ready);                                // 释放就绪集合
+    void (*enqueue)(void *ready, PCB processes[], int idx);      // 进程变为就绪（新到达或被换下）
+    int (*pick_next)(void *ready, PCB processes[], int current_time); // 取出下一个运行进程，无则返回 -1
+    int (*time_slice)(void *ready, PCB processes[], int idx);    // 可选：本次分派的时间片，NULL 或 0 表示运行到完成
+    int (*should_preempt)(void *ready, PCB processes[], int running, int ran); // 可选：运行进程已运行 ran 后是否被就绪进程抢占
+    void (*on_tick)(void *ready, PCB processes[], int idx, int ran);   // 可选：进程运行 ran 后未完成即被换下（时间片到期、被抢占或转入 I/O）
+    void (*on_complete)(void *ready, PCB processes[], int idx);        // 可选：进程运行完成
+    void (*on_migrate)(void *from, void *to, PCB processes[], int idx); // 可选：进程从一个 CPU 的就绪集合迁到另一个（多 CPU 模拟）
+} SchedPolicy;
+
+// 函数：进程未完成即离开 CPU，扣除运行时间后交还调度策略
+void preemptProcess(const SchedPolicy *policy, void *ready, PCB processes[], int idx, int ran) {
+    processes[idx].remaining_time -= ran; // 扣除本次运行时间
+    processes[idx].state = 'W'; // 设置为等待/就绪状态
+    if (policy->on_tick != NULL) {
+        policy->on_tick(ready, processes, idx, ran);
+    }
+    policy->enqueue(ready, processes, idx);
+}
+
+// 函数：进程的 CPU 区间运行完毕但还有后续区间，离开 CPU 转入阻塞状态，不回到就绪集合
+void blockProcess(const SchedPolicy *policy, void *ready, PCB processes[], int idx, int ran) {
+    processes[idx].remaining_time -= ran; // 扣除本次运行时间
+    processes[idx].state = 'B'; // 设置为阻塞状态
+    if (policy->on_tick != NULL) {
+        policy->on_tick(ready, processes, idx, ran);
+    }
+}
+
+// 函数：在事件日历上用指定调度策略运行一次模拟
+void runSimulation(Simulation *sim, const SchedPolicy *policy) {
+    EventCalendar calendar; // 事件日历
+    calendarInit(&calendar);
+    void *ready = policy->create(sim); // 就绪集合
+
+    int running_process_idx = -1; // 正在运行的进程
+    int last_process = -1;        // 上一个在 CPU 上运行的进程，用于判断是否需要上下文切换
+    int dispatch_time = 0;        // 正在运行进程本次开始运行的时间（分派时间加上切换开销）
+    int run_length = 0;           // 正在运行进程本次计划运行的时间
+    int dispatch = 0;             // 分派序号，用于识别过期的 CPU 事件
+    int live_processes = 0;       // 已到达（或已登记到达事件）但未完成的进程数（含等待 I/O 的进程）
+    int changed = 0;              // 当前时刻是否有进程到达或离开 CPU（只有过期事件时不做调度决策）
+
+    // 到达事件只登记下一个，处理时再补充，日历规模与进程数无关
+    int first = simNextArrival(sim);
+    if (first != -1) {
+        calendarPush(&calendar, sim->processes[first].arrival_time, EVENT_ARRIVAL, first, 0);
+        live_processes++;
+    }
+
+    while (live_processes > 0) { // 循环直到所有进程完成
+        Event ev = calendarPop(&calendar);
+        sim->current_time = ev.time; // 时钟跳到事件发生时刻
+
+        if (ev.type == EVENT_ARRIVAL) {
+            policy->enqueue(ready, sim->processes, ev.idx); // 新进程进入就绪集合
+            changed = 1;
+            int next = simNextArrival(sim);
+            if (next != -1) {
+                calendarPush(&calendar, sim->processes[next].arrival_time, EVENT_ARRIVAL, next, 0);
+                live_processes++;
+            }
+        } else if (ev.type == EVENT_IO_COMPLETE) {
+            int idx = simFinishIo(sim, ev.idx);
+            policy->enqueue(ready, sim->processes, idx); // I/O 完成的进程回到就绪集合
+            changed = 1;
+            if (sim->devices[ev.idx].busy != -1) {
+                calendarPush(&calendar, sim->devices[ev.idx].finish_time, EVENT_IO_COMPLETE, ev.idx, 0);
+            }
+        } else if (ev.dispatch == dispatch) { // 分派序号不符的是被抢占进程的过期事件
+            PCB *p = &sim->processes[ev.idx];
+            if (ev.type == EVENT_COMPLETE && p->burst_index + 1 < p->num_bursts) { // CPU 区间结束，转入 I/O
+                sim->busy_time += run_length;
+                blockProcess(policy, ready, sim->processes, ev.idx, run_length);
+                int d = simStartIo(sim, ev.idx);
+                if (d != -1) {
+                    calendarPush(&calendar, sim->devices[d].finish_time, EVENT_IO_COMPLETE, d, 0);
+                }
+            } else if (ev.type == EVENT_COMPLETE) {
+                p->remaining_time -= run_length; // 扣除本次运行时间
+                p->state = 'F'; // 设置为完成状态
+                p->finish_time = sim->current_time; // 记录完成时间
+                p->turnaround_time = p->finish_time - p->arrival_time; // 计算周转时间
+                sim->busy_time += run_length;
+                live_processes--;
+                if (policy->on_complete != NULL) {
+                    policy->on_complete(ready, sim->processes, ev.idx);
+                }
+                simRecordCompletion(sim, ev.idx);
+            } else { // 时间片到期，放回就绪集合
+                sim->busy_time += run_length;
+                preemptProcess(policy, ready, sim->processes, ev.idx, run_length);
+            }
+            running_process_idx = -1;
+            changed = 1;
+        }
+
+        // 同一时刻的事件全部处理完后再做调度决策
+        if ((calendar.size > 0 && calendar.items[0].time == sim->current_time) || !changed) {
+            continue;
+        }
+        changed = 0;
+        // 可抢占的策略：检查就绪进程是否应当抢占正在运行的进程
+        if (running_process_idx != -1 && policy->should_preempt != NULL) {
+            int ran = sim->current_time - dispatch_time;
+            if (policy->should_preempt(ready, sim->processes, running_process_idx, ran > 0 ? ran : 0)) {
+                if (ran < 0) { // 切换尚未完成即被抢占，未用完的切换时间不计
+                    sim->switch_time += ran;
+                    ran = 0;
+                }
+                sim->busy_time += ran;
+                preemptProcess(policy, ready, sim->processes, running_process_idx, ran);
+                running_process_idx = -1;
+                dispatch++; // 使被抢占进程已登记的事件过期
+            }
+        }
+        // CPU 空闲则调度下一个进程
+        if (running_process_idx == -1) {
+            running_process_idx = policy->pick_next(ready, sim->processes, sim->current_time);
+            if (running_process_idx != -1) {
+                PCB *p = &sim->processes[running_process_idx];
+                int overhead = 0; // 换上不同的进程时先付出切换开销
+                if (last_process != -1 && last_process != running_process_idx) {
+                    sim->context_switches++;
+                    overhead = sim->switch_cost;
+                    sim->switch_time += overhead;
+                }
+                last_process = running_process_idx;
+                p->state = 'R'; // 设置为运行状态
+                if (p->start_time == -1) {
+                    p->start_time = sim->current_time + overhead; // 记录开始时间
+                }
+
+                if (sim->verbosity >= VERBOSITY_STATUS) {
+                    printStatus(sim->current_time, sim->processes, sim->num_processes, running_process_idx); // 打印当前状态
+                }
+
+                // 计算本次运行的时间，并登记完成或时间片到期事件
+                int slice = (policy->time_slice != NULL) ? policy->time_slice(ready, sim->processes, running_process_idx) : 0;
+                dispatch++;
+                sim->dispatches++;
+                dispatch_time = sim->current_time + overhead;
+                if (slice > 0 && p->remaining_time > slice) {
+                    run_length = slice;
+                    calendarPush(&calendar, dispatch_time + run_length, EVENT_SLICE_END, running_process_idx, dispatch);
+                } else {
+                    run_length = p->remaining_time;
+                    calendarPush(&calendar, dispatch_time + run_length, EVENT_COMPLETE, running_process_idx, dispatch);
+                }
+            }
+        }
+    }
+
+    policy->destroy(ready);
+    calendarFree(&calendar);
+}
+
+// 函数：准备模拟的进程来源：周期任务集、轨迹文件（均为流式）或预先生成的进程
+int simInit(Simulation *sim, const Workload *workload) {
+    if (workload->task_set != NULL) {
+        simInitTasks(sim, workload->task_set);
+        return 1;
+    }
+    if (workload->trace_path != NULL) {
+        return simInitTrace(sim, workload->trace_path);
+    }
+    simInitProcesses(sim, workload->processes, workload->num_processes);
+    return 1;
+}
+
+// 函数：模拟结束后的平均周转时间
+double simAverageTurnaround(const Simulation *sim) {
+    return sim->latency.turnaround.total ? sim->latency.turnaround.sum / sim->latency.turnaround.total : 0.0;
+}
+
+// 函数：输出上下文切换次数、吞吐量（每单位时间完成的进程数）、CPU 利用率和 CPU 效率（进程运行时间占 CPU 忙碌时间的比例）
+// makespan 为模拟的总时长，多 CPU 时为总时长乘以 CPU 数
+void printCpuEfficiency(const Simulation *sim, long long makespan) {
+    long long occupied = sim->busy_time + sim->switch_time;
+    printf("上下文切换 %lld 次（每次开销 %d），吞吐量 %.4f 个/单位时间，CPU 利用率 %.1f%%，CPU 效率 %.1f%%\n",
+           sim->context_switches, sim->switch_cost,
+           sim->current_time > 0 ? (double)sim->completed / sim->current_time : 0.0,
+           makespan > 0 ? 100.0 * occupied / makespan : 0.0,
+           occupied > 0 ? 100.0 * sim->busy_time / occupied : 100.0);
+}
+
+// 函数：输出各 I/O 设备的利用率和完成的请求数，没有 I/O 时不输出
+void printDeviceUtilization(const Simulation *sim) {
+    if (sim->num_devices == 0) {
+        return;
+    }
+    printf("设备利用率:");
+    for (int d = 0; d < sim->num_devices; d++) {
+        printf("%s 设备%d %.1f%%（%lld 次请求）", (d % 4 == 0 && d > 0) ? "\n          " : "", d,
+               sim->current_time > 0 ? 100.0 * sim->devices[d].busy_time / sim->current_time : 0.0,
+               sim->devices[d].requests);
+    }
+    printf("\n");
+}
+
+// 函数：打印最终状态、平均周转时间和延迟分布
+void printSimulationResult(const char *algorithm, Simulation *sim) {
+    if (sim->verbosity < VERBOSITY_RESULT) {
+        return;
+    }
+    if (sim->verbosity >= VERBOSITY_STATUS) {
+        printStatus(sim->current_time, sim->processes, sim->num_processes, -1); // 打印最终状态
+    }
+    if (sim->streaming) {
+        printf("\n共 %lld 个进程，最大同时存活 %d 个\n", sim->completed, sim->num_processes);
+        printf("%s 平均周转时间: %.2f\n", algorithm, simAverageTurnaround(sim));
+    } else {
+        printf("\n%s 平均周转时间: %.2f\n", algorithm, simAverageTurnaround(sim));
+    }
+    printCpuEfficiency(sim, sim->current_time);
+    printDeviceUtilization(sim);
+    printLatencyStats(&sim->latency);
+}
+
+// 函数：用指定调度策略运行模拟，并按详细程度输出过程和结果
+void runPolicy(Simulation *sim, const SchedPolicy *policy) {
+    if (sim->verbosity >= VERBOSITY_RESULT) {
+        if (policy->uses_time_slice) {
+            printf("\n\n=== %s 调度 (时间片: %d) ===\n", policy->title, sim->time_slice);
+        } else {
+            printf("\n\n=== %s 调度 ===\n", policy->title);
+        }
+    }
+    runSimulation(sim, policy);
+    printSimulationResult(policy->name, sim);
+}
+
+// 以二叉堆为就绪集合的策略共用的操作
+void heapDestroy(void *ready) {
+    heapFree((ProcessHeap *)ready);
+    free(ready);
+}
+
+void heapEnqueue(void *ready, PCB processes[], int idx) {
+    heapPush((ProcessHeap *)ready, processes, idx);
+}
+
+int heapPickNext(void *ready, PCB processes[], int current_time) {
+    (void)current_time;
+    return heapPop((ProcessHeap *)ready, processes);
+}
+
+// --- 短进程优先 (SJF) 调度算法 ---
+// 就绪集合为按爆发时间排序的最小堆，不可抢占，进程运行到完成
+void* sjfCreate(const Simulation *sim) {
+    (void)sim;
+    ProcessHeap *heap = (ProcessHeap *)checkedRealloc(NULL, sizeof(ProcessHeap));
+    heapInit(heap, shorterBurst);
+    return heap;
+}
+
+const SchedPolicy sjf_policy = {
+    "SJF", "短进程优先 (SJF)", 0,
+    sjfCreate, heapDestroy, heapEnqueue, heapPickNext,
+    NULL, NULL, NULL, NULL, NULL
+};
+
+// --- 时间片轮转 (RR) 调度算法 ---
+// 就绪集合为先来先服务的运行队列，时间片到期的进程回到队尾
+typedef struct {
+    RunQueue queue;  // RR 的就绪队列
+    int time_slice;  // 时间片大小
+} RRReady;
+
+void* rrCreate(const Simulation *sim) {
+    RRReady *rr = (RRReady *)checkedRealloc(NULL, sizeof(RRReady));
+    runQueueInit(&rr->queue);
+    rr->time_slice = sim->time_slice;
+    return rr;
+}
+
+void rrDestroy(void *ready) {
+    runQueueFree(&((RRReady *)ready)->queue);
+    free(ready);
+}
+
+void rrEnqueue(void *ready, PCB processes[], int idx) {
+    if (processes[idx].queued) { // 已在队列中，避免重复添加
+        return;
+    }
+    processes[idx].queued = 1;
+    runQueuePush(&((RRReady *)ready)->queue, idx); // 将进程下标放入队列尾部
+}
+
+int rrPickNext(void *ready, PCB processes[], int current_time) {
+    (void)current_time;
+    int idx = runQueuePop(&((RRReady *)ready)->queue); // 取出队列头部的进程
+    if (idx != -1) {
+        processes[idx].queued = 0;
+    }
+    return idx;
+}
+
+int rrTimeSlice(void *ready, PCB processes[], int idx) {
+    (void)processes;
+    (void)idx;
+    return ((RRReady *)ready)->time_slice;
+}
+
+// 时间片到期的进程排在同一时刻新到达的进程之后
+const SchedPolicy rr_policy = {
+    "RR", "时间片轮转 (RR)", 1,
+    rrCreate, rrDestroy, rrEnqueue, rrPickNext,
+    rrTimeSlice, NULL, NULL, NULL, NULL
+};
+
+// --- 高响应比优先 (HRRF) 调度算法 ---
+// 就绪集合为按响应比组织的锦标赛树，不可抢占，进程运行到完成
+void* hrrfCreate(const Simulation *sim) {
+    (void)sim;
+    KineticTree *kt = (KineticTree *)checkedRealloc(NULL, sizeof(KineticTree));
+    kineticInit(kt);
+    return kt;
+}
+
+void hrrfDestroy(void *ready) {
+    kineticFree((KineticTree *)ready);
+    free(ready);
+}
+
+void hrrfEnqueue(void *ready, PCB processes[], int idx) {
+    kineticPush((KineticTree *)ready, processes, idx);
+}
+
+int hrrfPickNext(void *ready, PCB processes[], int current_time) {
+    // 响应比 = (等待时间 + 运行时间) / 运行时间，取已到达且就绪的进程中最高者
+    return kineticPopHighest((KineticTree *)ready, processes, current_time);
+}
+
+const SchedPolicy hrrf_policy = {
+    "HRRF", "高响应比优先 (HRRF)", 0,
+    hrrfCreate, hrrfDestroy, hrrfEnqueue, hrrfPickNext,
+    NULL, NULL, NULL, NULL, NULL
+};
+
+// --- 最短剩余时间优先 (SRTF) 调度算法 ---
+// SJF 的抢占式版本：就绪堆按剩余时间排序，新到达进程的剩余时间
+// 严格小于正在运行进程的剩余时间时立即抢占
+int shorterRemaining(const PCB processes[], int a, int b) {
+    if (processes[a].remaining_time != processes[b].remaining_time) {
+        return processes[a].remaining_time < processes[b].remaining_time;
+    }
+    return processes[a].pid < processes[b].pid;
+}
+
+void* srtfCreate(const Simulation *sim) {
+    (void)sim;
+    ProcessHeap *heap = (ProcessHeap *)checkedRealloc(NULL, sizeof(ProcessHeap));
+    heapInit(heap, shorterRemaining);
+    return heap;
+}
+
+int srtfShouldPreempt(void *ready, PCB processes[], int running, int ran) {
+    ProcessHeap *heap = (ProcessHeap *)ready;
+    return heap->size > 0 &&
+           processes[heap->items[0]].remaining_time < processes[running].remaining_time - ran;
+}
+
+const SchedPolicy srtf_policy = {
+    "SRTF", "最短剩余时间优先 (SRTF)", 0,
+    srtfCreate, heapDestroy, heapEnqueue, heapPickNext,
+    NULL, srtfShouldPreempt, NULL, NULL, NULL
+};
+
+// --- 多级反馈队列 (MLFQ) 调度算法 ---
+// 新进程进入最高级队列；用完整个时间片仍未完成则降一级，第 k 级时间片为基本时间片的 2^k 倍。
+// 高级队列有进程就绪时抢占低级队列的进程；每隔 MLFQ_BOOST_PERIOD 把所有进程提升回最高级，防止饥饿。
+// 进程所在级别记录在 PCB 的 priority 字段中。
+#define MLFQ_LEVELS 3          // 队列级数
+#define MLFQ_BOOST_PERIOD 100  // 优先级提升周期
+
+typedef struct {
+    RunQueue queues[MLFQ_LEVELS]; // 各级就绪队列，0 级最高
+    int base_quantum;             // 最高级队列的时间片
+    int next_boost;               // 下一次优先级提升的时间
+} MLFQReady;
+
+void* mlfqCreate(const Simulation *sim) {
+    MLFQReady *m = (MLFQReady *)checkedRealloc(NULL, sizeof(MLFQReady));
+    for (int level = 0; level < MLFQ_LEVELS; level++) {
+        runQueueInit(&m->queues[level]);
+    }
+    m->base_quantum = sim->time_slice;
+    m->next_boost = MLFQ_BOOST_PERIOD;
+    return m;
+}
+
+void mlfqDestroy(void *ready) {
+    MLFQReady *m = (MLFQReady *)ready;
+    for (int level = 0; level < MLFQ_LEVELS; level++) {
+        runQueueFree(&m->queues[level]);
+    }
+    free(m);
+}
+
+void mlfqEnqueue(void *ready, PCB processes[], int idx) {
+    if (processes[idx].start_time == -1) {
+        processes[idx].priority = 0; // 新进程进入最高级队列
+    }
+    runQueuePush(&((MLFQReady *)ready)->queues[processes[idx].priority], idx);
+}
+
+int mlfqPickNext(void *ready, PCB processes[], int current_time) {
+    MLFQReady *m = (MLFQReady *)ready;
+    if (current_time >= m->next_boost) { // 优先级提升：低级队列的进程按原顺序移到最高级
+        for (int level = 1; level < MLFQ_LEVELS; level++) {
+            int idx;
+            while ((idx = runQueuePop(&m->queues[level])) != -1) {
+                processes[idx].priority = 0;
+                runQueuePush(&m->queues[0], idx);
+            }
+        }
+        m->next_boost = (current_time / MLFQ_BOOST_PERIOD + 1) * MLFQ_BOOST_PERIOD;
+    }
+    for (int level = 0; level < MLFQ_LEVELS; level++) {
+        if (m->queues[level].count > 0) {
+            return runQueuePop(&m->queues[level]);
+        }
+    }
+    return -1;
+}
+
+int mlfqTimeSlice(void *ready, PCB processes[], int idx) {
+    return ((MLFQReady *)ready)->base_quantum << processes[idx].priority;
+}
+
+int mlfqShouldPreempt(void *ready, PCB processes[], int running, int ran) {
+    (void)ran;
+    MLFQReady *m = (MLFQReady *)ready;
+    for (int level = 0; level < processes[running].priority; level++) {
+        if (m->queues[level].count > 0) {
+            return 1; // 更高级队列中有进程就绪
+        }
+    }
+    return 0;
+}
+
+void mlfqOnTick(void *ready, PCB processes[], int idx, int ran) {
+    MLFQReady *m = (MLFQReady *)ready;
+    int level = processes[idx].priority;
+    if (ran >= (m->base_quantum << level) && level < MLFQ_LEVELS - 1) {
+        processes[idx].priority = level + 1; // 用完整个时间片，降一级
+    }
+}
+
+const SchedPolicy mlfq_policy = {
+    "MLFQ", "多级反馈队列 (MLFQ)", 1,
+    mlfqCreate, mlfqDestroy, mlfqEnqueue, mlfqPickNext,
+    mlfqTimeSlice, mlfqShouldPreempt, mlfqOnTick, NULL, NULL
+};
+
+// --- 完全公平调度 (CFS) 算法 ---
+// 仿照 Linux CFS：每个进程累计虚拟运行时间 vruntime（所有进程权重相同，即实际运行时间），
+// 就绪进程按 (vruntime, 序号) 存放在红黑树中，总是选择最左节点（缓存，O(1) 取得）。
+// 时间片为调度周期按就绪进程数平分，且不小于最小粒度；新进程以当前 min_vruntime 加入，
+// I/O 完成后唤醒的进程 vruntime 不低于 min_vruntime 减半个调度周期，
+// 其 vruntime 比正在运行进程小超过唤醒粒度时抢占。
+#define CFS_SCHED_LATENCY 12      // 调度周期
+#define CFS_MIN_GRANULARITY 2     // 最小时间片
+#define CFS_WAKEUP_GRANULARITY 2  // 唤醒抢占粒度
+#define RB_RED 0
+#define RB_BLACK 1
+
+// 红黑树节点号为进程下标 + 1，节点 0 为哨兵（NIL）
+typedef struct {
+    int *left, *right, *parent;
+    char *color;
+    long long *vruntime;   // 按进程下标 + 1 索引
+    int capacity;          // 可容纳的最大节点号
+    int root;
+    int leftmost;          // 缓存的最左节点（vruntime 最小）
+    int count;             // 树中进程数
+    long long min_vruntime; // 单调不减的最小 vruntime
+} CFSReady;
+
+void* cfsCreate(const Simulation *sim) {
+    (void)sim;
+    CFSReady *t = (CFSReady *)checkedRealloc(NULL, sizeof(CFSReady));
+    memset(t, 0, sizeof(*t));
+    return t;
+}
+
+void cfsDestroy(void *ready) {
+    CFSReady *t = (CFSReady *)ready;
+    free(t->left);
+    free(t->right);
+    free(t->parent);
+    free(t->color);
+    free(t->vruntime);
+    free(t);
+}
+
+// 函数：确保节点号 node 可用
+void cfsReserve(CFSReady *t, int node) {
+    if (node <= t->capacity && t->left != NULL) {
+        return;
+    }
+    int capacity = t->capacity ? t->capacity : 16;
+    while (capacity < node) {
+        capacity *= 2;
+    }
+    t->left = (int *)checkedRealloc(t->left, sizeof(int) * (capacity + 1));
+    t->right = (int *)checkedRealloc(t->right, sizeof(int) * (capacity + 1));
+    t->parent = (int *)checkedRealloc(t->parent, sizeof(int) * (capacity + 1));
+    t->color = (char *)checkedRealloc(t->color, sizeof(char) * (capacity + 1));
+    t->vruntime = (long long *)checkedRealloc(t->vruntime, sizeof(long long) * (capacity + 1));
+    if (t->capacity == 0) {
+        t->left[0] = t->right[0] = t->parent[0] = 0; // 哨兵
+        t->color[0] = RB_BLACK;
+    }
+    t->capacity = capacity;
+}
+
+int cfsBefore(const CFSReady *t, const PCB processes[], int a, int b) {
+    if (t->vruntime[a] != t->vruntime[b]) {
+        return t->vruntime[a] < t->vruntime[b];
+    }
+    return processes[a - 1].pid < processes[b - 1].pid;
+}
+
+void rbRotateLeft(CFSReady *t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != 0) {
+        t->parent[t->left[y]] = x;
+    }
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == 0) {
+        t->root = y;
+    } else if (x == t->left[t->parent[x]]) {
+        t->left[t->parent[x]] = y;
+    } else {
+        t->right[t->parent[x]] = y;
+    }
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+void rbRotateRight(CFSReady *t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != 0) {
+        t->parent[t->right[y]] = x;
+    }
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == 0) {
+        t->root = y;
+    } else if (x == t->right[t->parent[x]]) {
+        t->right[t->parent[x]] = y;
+    } else {
+        t->left[t->parent[x]] = y;
+    }
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+void rbInsert(CFSReady *t, const PCB processes[], int z) {
+    int y = 0, x = t->root;
+    while (x != 0) {
+        y = x;
+        x = cfsBefore(t, processes, z, x) ? t->left[x] : t->right[x];
+    }
+    t->parent[z] = y;
+    if (y == 0) {
+        t->root = z;
+    } else if (cfsBefore(t, processes, z, y)) {
+        t->left[y] = z;
+    } else {
+        t->right[y] = z;
+    }
+    t->left[z] = t->right[z] = 0;
+    t->color[z] = RB_RED;
+    if (t->leftmost == 0 || cfsBefore(t, processes, z, t->leftmost)) {
+        t->leftmost = z;
+    }
+
+    while (t->color[t->parent[z]] == RB_RED) { // 插入修复
+        int g = t->parent[t->parent[z]];
+        if (t->parent[z] == t->left[g]) {
+            int u = t->right[g];
+            if (t->color[u] == RB_RED) {
+                t->color[t->parent[z]] = t->color[u] = RB_BLACK;
+                t->color[g] = RB_RED;
+                z = g;
+            } else {
+                if (z == t->right[t->parent[z]]) {
+                    z = t->parent[z];
+                    rbRotateLeft(t, z);
+                }
+                t->color[t->parent[z]] = RB_BLACK;
+                t->color[t->parent[t->parent[z]]] = RB_RED;
+                rbRotateRight(t, t->parent[t->parent[z]]);
+            }
+        } else {
+            int u = t->left[g];
+            if (t->color[u] == RB_RED) {
+                t->color[t->parent[z]] = t->color[u] = RB_BLACK;
+                t->color[g] = RB_RED;
+                z = g;
+            } else {
+                if (z == t->left[t->parent[z]]) {
+                    z = t->parent[z];
+                    rbRotateRight(t, z);
+                }
+                t->color[t->parent[z]] = RB_BLACK;
+                t->color[t->parent[t->parent[z]]] = RB_RED;
+                rbRotateLeft(t, t->parent[t->parent[z]]);
+            }
+        }
+    }
+    t->color[t->root] = RB_BLACK;
+}
+
+void rbTransplant(CFSReady *t, int u, int v) {
+    if (t->parent[u] == 0) {
+        t->root = v;
+    } else if (u == t->left[t->parent[u]]) {
+        t->left[t->parent[u]] = v;
+    } else {
+        t->right[t->parent[u]] = v;
+    }
+    t->parent[v] = t->parent[u];
+}
+
+int rbMinimum(const CFSReady *t, int x) {
+    while (t->left[x] != 0) {
+        x = t->left[x];
+    }
+    return x;
+}
+
+void rbErase(CFSReady *t, int z) {
+    if (z == t->leftmost) { // 最左节点没有左孩子，后继为右子树最小者或父节点
+        t->leftmost = (t->right[z] != 0) ? rbMinimum(t, t->right[z]) : t->parent[z];
+    }
+    int y = z, x;
+    char y_color = t->color[y];
+    if (t->left[z] == 0) {
+        x = t->right[z];
+        rbTransplant(t, z, t->right[z]);
+    } else if (t->right[z] == 0) {
+        x = t->left[z];
+        rbTransplant(t, z, t->left[z]);
+    } else {
+        y = rbMinimum(t, t->right[z]);
+        y_color = t->color[y];
+        x = t->right[y];
+        if (t->parent[y] == z) {
+            t->parent[x] = y;
+        } else {
+            rbTransplant(t, y, t->right[y]);
+            t->right[y] = t->right[z];
+            t->parent[t->right[y]] = y;
+        }
+        rbTransplant(t, z, y);
+        t->left[y] = t->left[z];
+        t->parent[t->left[y]] = y;
+        t->color[y] = t->color[z];
+    }
+
+    if (y_color == RB_BLACK) { // 删除修复
+        while (x != t->root && t->color[x] == RB_BLACK) {
+            if (x == t->left[t->parent[x]]) {
+                int w = t->right[t->parent[x]];
+                if (t->color[w] == RB_RED) {
+                    t->color[w] = RB_BLACK;
+                    t->color[t->parent[x]] = RB_RED;
+                    rbRotateLeft(t, t->parent[x]);
+                    w = t->right[t->parent[x]];
+                }
+                if (t->color[t->left[w]] == RB_BLACK && t->color[t->right[w]] == RB_BLACK) {
+                    t->color[w] = RB_RED;
+                    x = t->parent[x];
+                } else {
+                    if (t->color[t->right[w]] == RB_BLACK) {
+                        t->color[t->left[w]] = RB_BLACK;
+                        t->color[w] = RB_RED;
+                        rbRotateRight(t, w);
+                        w = t->right[t->parent[x]];
+                    }
+                    t->color[w] = t->color[t->parent[x]];
+                    t->color[t->parent[x]] = RB_BLACK;
+                    t->color[t->right[w]] = RB_BLACK;
+                    rbRotateLeft(t, t->parent[x]);
+                    x = t->root;
+                }
+            } else {
+                int w = t->left[t->parent[x]];
+                if (t->color[w] == RB_RED) {
+                    t->color[w] = RB_BLACK;
+                    t->color[t->parent[x]] = RB_RED;
+                    rbRotateRight(t, t->parent[x]);
+                    w = t->left[t->parent[x]];
+                }
+                if (t->color[t->right[w]] == RB_BLACK && t->color[t->left[w]] == RB_BLACK) {
+                    t->color[w] = RB_RED;
+                    x = t->parent[x];
+                } else {
+                    if (t->color[t->left[w]] == RB_BLACK) {
+                        t->color[t->right[w]] = RB_BLACK;
+                        t->color[w] = RB_RED;
+                        rbRotateLeft(t, w);
+                        w = t->left[t->parent[x]];
+                    }
+                    t->color[w] = t->color[t->parent[x]];
+                    t->color[t->parent[x]] = RB_BLACK;
+                    t->color[t->left[w]] = RB_BLACK;
+                    rbRotateRight(t, t->parent[x]);
+                    x = t->root;
+                }
+            }
+        }
+        t->color[x] = RB_BLACK;
+    }
+}
+
+void cfsEnqueue(void *ready, PCB processes[], int idx) {
+    CFSReady *t = (CFSReady *)ready;
+    int node = idx + 1;
+    cfsReserve(t, node);
+    if (processes[idx].start_time == -1) {
+        t->vruntime[node] = t->min_vruntime; // 新进程从当前 min_vruntime 开始
+    } else if (processes[idx].burst_index > 0 && processes[idx].remaining_time == processes[idx].burst_time &&
+               t->vruntime[node] < t->min_vruntime - CFS_SCHED_LATENCY / 2) {
+        t->vruntime[node] = t->min_vruntime - CFS_SCHED_LATENCY / 2; // I/O 唤醒：补偿不超过半个调度周期
+    }
+    rbInsert(t, processes, node);
+    t->count++;
+}
+
+int cfsPickNext(void *ready, PCB processes[], int current_time) {
+    (void)processes;
+    (void)current_time;
+    CFSReady *t = (CFSReady *)ready;
+    int node = t->leftmost;
+    if (node == 0) {
+        return -1;
+    }
+    rbErase(t, node);
+    t->count--;
+    if (t->vruntime[node] > t->min_vruntime) {
+        t->min_vruntime = t->vruntime[node];
+    }
+    return node - 1;
+}
+
+int cfsTimeSlice(void *ready, PCB processes[], int idx) {
+    (void)processes;
+    (void)idx;
+    int slice = CFS_SCHED_LATENCY / (((CFSReady *)ready)->count + 1); // 就绪进程加上正在运行的进程
+    return slice > CFS_MIN_GRANULARITY ? slice : CFS_MIN_GRANULARITY;
+}
+
+int cfsShouldPreempt(void *ready, PCB processes[], int running, int ran) {
+    (void)processes;
+    CFSReady *t = (CFSReady *)ready;
+    return t->leftmost != 0 &&
+           t->vruntime[t->leftmost] + CFS_WAKEUP_GRANULARITY < t->vruntime[running + 1] + ran;
+}
+
+void cfsOnTick(void *ready, PCB processes[], int idx, int ran) {
+    (void)processes;
+    ((CFSReady *)ready)->vruntime[idx + 1] += ran; // 权重相同，虚拟运行时间即实际运行时间
+}
+
+// 迁移时保持进程相对于所在队列 min_vruntime 的位置，不因两个 CPU 的 vruntime 基准不同而获利或吃亏
+void cfsOnMigrate(void *from, void *to, PCB processes[], int idx) {
+    (void)processes;
+    CFSReady *src = (CFSReady *)from;
+    CFSReady *dst = (CFSReady *)to;
+    cfsReserve(dst, idx + 1);
+    dst->vruntime[idx + 1] = src->vruntime[idx + 1] - src->min_vruntime + dst->min_vruntime;
+}
+
+const SchedPolicy cfs_policy = {
+    "CFS", "完全公平调度 (CFS)", 0,
+    cfsCreate, cfsDestroy, cfsEnqueue, cfsPickNext,
+    cfsTimeSlice, cfsShouldPreempt, cfsOnTick, NULL, cfsOnMigrate
+};
+
+// --- 最早截止时间优先 (EDF) 调度算法 ---
+// 就绪堆按作业的绝对截止时间排序，新到达作业的截止时间严格早于正在运行作业时立即抢占。
+// 没有截止时间的进程 (-1) 排在最前，与实时作业混合时应只使用周期任务集
+int earlierDeadline(const PCB processes[], int a, int b) {
+    if (processes[a].deadline != processes[b].deadline) {
+        return processes[a].deadline < processes[b].deadline;
+    }
+    return processes[a].pid < processes[b].pid;
+}
+
+void* edfCreate(const Simulation *sim) {
+    (void)sim;
+    ProcessHeap *heap = (ProcessHeap *)checkedRealloc(NULL, sizeof(ProcessHeap));
+    heapInit(heap, earlierDeadline);
+    return heap;
+}
+
+int edfShouldPreempt(void *ready, PCB processes[], int running, int ran) {
+    (void)ran;
+    ProcessHeap *heap = (ProcessHeap *)ready;
+    return heap->size > 0 && processes[heap->items[0]].deadline < processes[running].deadline;
+}
+
+const SchedPolicy edf_policy = {
+    "EDF", "最早截止时间优先 (EDF)", 0,
+    edfCreate, heapDestroy, heapEnqueue, heapPickNext,
+    NULL, edfShouldPreempt, NULL, NULL, NULL
+};
+
+// --- 单调速率 (RM) 调度算法 ---
+// 静态优先级：周期越短优先级越高，周期相同时任务序号（priority）小者优先，同一任务的作业按释放顺序。
+// 更高优先级的作业到达时立即抢占
+int higherRateMonotonic(const PCB processes[], int a, int b) {
+    if (processes[a].period != processes[b].period) {
+        return processes[a].period < processes[b].period;
+    }
+    if (processes[a].priority != processes[b].priority) {
+        return processes[a].priority < processes[b].priority;
+    }
+    return processes[a].pid < processes[b].pid;
+}
+
+void* rmCreate(const Simulation *sim) {
+    (void)sim;
+    ProcessHeap *heap = (ProcessHeap *)checkedRealloc(NULL, sizeof(ProcessHeap));
+    heapInit(heap, higherRateMonotonic);
+    return heap;
+}
+
+int rmShouldPreempt(void *ready, PCB processes[], int running, int ran) {
+    (void)ran;
+    ProcessHeap *heap = (ProcessHeap *)ready;
+    return heap->size > 0 && higherRateMonotonic(processes, heap->items[0], running);
+}
+
+const SchedPolicy rm_policy = {
+    "RM", "单调速率 (RM)", 0,
+    rmCreate, heapDestroy, heapEnqueue, heapPickNext,
+    NULL, rmShouldPreempt, NULL, NULL, NULL
+};
+
+// 所有调度策略，依次在同一份工作负载上运行
+const SchedPolicy *scheduling_policies[] = {
+    &sjf_policy, &rr_policy, &hrrf_policy, &srtf_policy, &mlfq_policy, &cfs_policy
+};
+#define NUM_POLICIES ((int)(sizeof(scheduling_policies) / sizeof(scheduling_policies[0])))
+
+// 实时调度策略，只在周期任务集上额外运行
+const SchedPolicy *realtime_policies[] = {
+    &edf_policy, &rm_policy
+};
+#define NUM_REALTIME_POLICIES ((int)(sizeof(realtime_policies) / sizeof(realtime_policies[0])))
+#define MAX_WORKLOAD_POLICIES (NUM_POLICIES + NUM_REALTIME_POLICIES)
+
+// 函数：工作负载上要运行的调度策略，返回策略数
+int workloadPolicies(const Workload *workload, const SchedPolicy *policies[]) {
+    int count = 0;
+    for (int i = 0; i < NUM_POLICIES; i++) {
+        policies[count++] = scheduling_policies[i];
+    }
+    for (int i = 0; workload->task_set != NULL && i < NUM_REALTIME_POLICIES; i++) {
+        policies[count++] = realtime_policies[i];
+    }
+    return count;
+}
+
+// 函数：在同一份工作负载上依次运行所有调度算法
+void runAllAlgorithms(const Workload *workload, const SimOptions *options) {
+    const SchedPolicy *policies[MAX_WORKLOAD_POLICIES];
+    int num_policies = workloadPolicies(workload, policies);
+    for (int i = 0; i < num_policies; i++) {
+        Simulation sim; // 每个算法使用独立的进程副本，确保各算法使用相同初始数据
+        if (!simInit(&sim, workload)) {
+            return;
+        }
+        simApplyOptions(&sim, options);
+        runPolicy(&sim, policies[i]);
+        simFree(&sim);
+    }
+}
+
+// --- 线程池 ---
+// 固定数量的工作线程从任务队列中取任务执行，submit 后用 threadPoolWait 等待全部完成
+typedef void (*TaskFunc)(void *arg);
+
+typedef struct {
+    TaskFunc func;
+    void *arg;
+} Task;
+
+typedef struct {
+    pthread_t *threads;
+    int num_threads;
+    Task *tasks;            // 任务环形队列
+    int task_head, task_count, task_capacity;
+    int pending;            // 已提交但未完成的任务数
+    int shutdown;           // 是否正在关闭
+    pthread_mutex_t lock;
+    pthread_cond_t has_task;   // 有新任务或需要关闭
+    pthread_cond_t all_done;   // 所有任务已完成
+} ThreadPool;
+
+void* threadPoolWorker(void *arg) {
+    ThreadPool *pool = (ThreadPool *)arg;
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->task_count == 0 && !pool->shutdown) {
+            pthread_cond_wait(&pool->has_task, &pool->lock);
+        }
+        if (pool->task_count == 0) { // 关闭且任务已取完
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        Task task = pool->tasks[pool->task_head];
+        pool->task_head = (pool->task_head + 1) % pool->task_capacity;
+        pool->task_count--;
+        pthread_mutex_unlock(&pool->lock);
+
+        task.func(task.arg);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_broadcast(&pool->all_done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// 函数：获取在线 CPU 核数
+int onlineCpuCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+void threadPoolInit(ThreadPool *pool, int num_threads) {
+    pool->num_threads = num_threads > 0 ? num_threads : 1;
+    pool->threads = (pthread_t *)checkedRealloc(NULL, sizeof(pthread_t) * pool->num_threads);
+    pool->task_capacity = 64;
+    pool->tasks = (Task *)checkedRealloc(NULL, sizeof(Task) * pool->task_capacity);
+    pool->task_head = pool->task_count = pool->pending = 0;
+    pool->shutdown = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->has_task, NULL);
+    pthread_cond_init(&pool->all_done, NULL);
+    for (int i = 0; i < pool->num_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, threadPoolWorker, pool) != 0) {
+            perror("Failed to create worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// 函数：提交一个任务
+void threadPoolSubmit(ThreadPool *pool, TaskFunc func, void *arg) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->task_count == pool->task_capacity) { // 队列满时扩容
+        Task *tasks = (Task *)checkedRealloc(NULL, sizeof(Task) * pool->task_capacity * 2);
+        for (int i = 0; i < pool->task_count; i++) {
+            tasks[i] = pool->tasks[(pool->task_head + i) % pool->task_capacity];
+        }
+        free(pool->tasks);
+        pool->tasks = tasks;
+        pool->task_head = 0;
+        pool->task_capacity *= 2;
+    }
+    pool->tasks[(pool->task_head + pool->task_count) % pool->task_capacity] = (Task){func, arg};
+    pool->task_count++;
+    pool->pending++;
+    pthread_cond_signal(&pool->has_task);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// 函数：等待已提交的任务全部完成
+void threadPoolWait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->all_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void threadPoolDestroy(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->has_task);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->has_task);
+    pthread_cond_destroy(&pool->all_done);
+    free(pool->threads);
+    free(pool->tasks);
+}
+
+// --- 工作负载生成器 ---
+// 按指定的到达间隔分布和运行时间分布生成进程，可直接生成到内存或写成二进制轨迹文件。
+// 进程按固定大小的块生成，每块的到达间隔和运行时间各用一个由 (种子, 块号) 导出的独立随机数流，
+// 块可以分给任意多个线程并行生成，结果只取决于种子和参数，与线程数无关。
+// 到达时间是到达间隔的前缀和：间隔以 1/2^16 为单位的定点数累加（整数加法满足结合律），
+// 第一遍求出每块的间隔之和，串行得到各块的起始偏移，第二遍重新生成同一随机数流并写出进程。
+#define WORKLOAD_CHUNK 65536          // 每块进程数
+#define WORKLOAD_FIXED_SHIFT 16       // 到达时间定点数的小数位数
+#define WORKLOAD_MAX_BURST 1000000    // 运行时间上限，截断重尾分布的极端值，避免模拟时间溢出
+#define WORKLOAD_BATCH_CHUNKS 64      // 写轨迹文件时每批生成的块数，决定缓冲区大小
+
+typedef enum {
+    ARRIVAL_UNIFORM,  // 到达间隔在 [0, 2 * 均值] 上均匀分布
+    ARRIVAL_POISSON   // 泊松到达：到达间隔服从指数分布
+} ArrivalDistribution;
+
+typedef enum {
+    BURST_UNIFORM,    // 运行时间在 [a, b] 上均匀分布
+    BURST_PARETO,     // Pareto 分布：形状 a，最小值 b
+    BURST_LOGNORMAL   // 对数正态分布：ln(运行时间) ~ N(a, b^2)
+} BurstDistribution;
+
+typedef struct {
+    ArrivalDistribution arrival;
+    double mean_interarrival;  // 平均到达间隔
+    BurstDistribution burst;
+    double burst_a, burst_b;   // 运行时间分布的参数，含义见 BurstDistribution
+} WorkloadSpec;
+
+// 函数：由种子和流编号导出一个独立随机数流的初始状态
+unsigned long long rngStreamSeed(unsigned long long seed, unsigned long long stream) {
+    Rng rng;
+    rngSeed(&rng, seed ^ (stream * 0xD1B54A32D192ED03ULL));
+    return rngNext(&rng);
+}
+
+// 函数：返回 (0, 1) 之间的随机实数
+double rngUnit(Rng *rng) {
+    return ((rngNext(rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// 函数：抽取一个到达间隔（定点数）
+long long sampleInterarrival(const WorkloadSpec *spec, Rng *rng) {
+    double gap;
+    if (spec->arrival == ARRIVAL_POISSON) {
+        gap = -spec->mean_interarrival * log(rngUnit(rng));
+    } else {
+        gap = 2.0 * spec->mean_interarrival * rngUnit(rng);
+    }
+    return (long long)(gap * (1 << WORKLOAD_FIXED_SHIFT));
+}
+
+// 函数：抽取一个运行时间（向上取整到 [1, WORKLOAD_MAX_BURST]）
+int sampleBurst(const WorkloadSpec *spec, Rng *rng) {
+    double burst;
+    if (spec->burst == BURST_PARETO) {
+        burst = spec->burst_b / pow(rngUnit(rng), 1.0 / spec->burst_a);
+    } else if (spec->burst == BURST_LOGNORMAL) {
+        double normal = sqrt(-2.0 * log(rngUnit(rng))) * cos(6.283185307179586 * rngUnit(rng)); // Box-Muller
+        burst = exp(spec->burst_a + spec->burst_b * normal);
+    } else {
+        burst = spec->burst_a + (spec->burst_b - spec->burst_a + 1) * rngUnit(rng) - 0.5;
+    }
+    if (!(burst < WORKLOAD_MAX_BURST)) { // 同时处理溢出为无穷大的情况
+        return WORKLOAD_MAX_BURST;
+    }
+    return burst < 1 ? 1 : (int)ceil(burst);
+}
+
+// 一块进程的生成任务
+typedef struct {
+    const WorkloadSpec *spec;
+    unsigned long long seed;
+    long long chunk;            // 块号
+    int count;                  // 块内进程数
+    long long gap_sum;          // 第一遍：块内到达间隔之和（定点数）
+    long long offset;           // 第二遍：块内第一个进程的到达时间（定点数）
+    PCB *processes;             // 第二遍输出到内存时的目标，否则为 NULL
+    unsigned char *records;     // 第二遍输出轨迹记录时的缓冲区
+} WorkloadChunk;
+
+void workloadSumChunk(void *arg) {
+    WorkloadChunk *chunk = (WorkloadChunk *)arg;
+    Rng rng;
+    rngSeed(&rng, rngStreamSeed(chunk->seed, 2 * chunk->chunk));
+    long long sum = 0;
+    for (int i = 0; i < chunk->count; i++) {
+        sum += sampleInterarrival(chunk->spec, &rng);
+    }
+    chunk->gap_sum = sum;
+}
+
+// 函数：写入 32 位小端整数
+void storeLE32(unsigned char *p, int value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+void workloadFillChunk(void *arg) {
+    WorkloadChunk *chunk = (WorkloadChunk *)arg;
+    Rng arrival_rng, burst_rng;
+    rngSeed(&arrival_rng, rngStreamSeed(chunk->seed, 2 * chunk->chunk));
+    rngSeed(&burst_rng, rngStreamSeed(chunk->seed, 2 * chunk->chunk + 1));
+    long long arrival = chunk->offset;
+    long long first = chunk->chunk * WORKLOAD_CHUNK; // 块内第一个进程的序号
+    for (int i = 0; i < chunk->count; i++) {
+        int arrival_time = (int)(arrival >> WORKLOAD_FIXED_SHIFT);
+        int burst_time = sampleBurst(chunk->spec, &burst_rng);
+        arrival += sampleInterarrival(chunk->spec, &arrival_rng);
+        if (chunk->processes != NULL) {
+            PCB *p = &chunk->processes[i];
+            snprintf(p->name, sizeof(p->name), "P%u", (unsigned int)((first + i + 1) % 100000000));
+            p->pid = (int)(first + i);
+            p->priority = 0;
+            p->arrival_time = arrival_time;
+            p->burst_time = burst_time;
+            p->remaining_time = burst_time;
+            p->start_time = -1;
+            p->finish_time = -1;
+            p->turnaround_time = 0;
+            p->state = 'W';
+            p->queued = 0;
+            p->affinity = -1;
+            p->cpu = -1;
+            p->period = 0;
+            p->deadline = -1;
+            p->ready_time = arrival_time;
+            p->cpu_time = burst_time;
+            p->io_time = 0;
+            p->bursts = NULL;
+            p->num_bursts = 1;
+            p->burst_index = 0;
+        } else {
+            unsigned char *rec = chunk->records + (size_t)i * TRACE_RECORD_SIZE;
+            storeLE32(rec, arrival_time);
+            storeLE32(rec + 4, burst_time);
+            memset(rec + 8, 0, 8); // 不写进程名，回放时按序号命名
+        }
+    }
+}
+
+// 函数：把进程划分成块，并行求各块的到达间隔之和，返回块数组（offset 已填好）
+WorkloadChunk* planWorkloadChunks(const WorkloadSpec *spec, long long num_processes, unsigned long long seed,
+                                  ThreadPool *pool, long long *num_chunks) {
+    *num_chunks = (num_processes + WORKLOAD_CHUNK - 1) / WORKLOAD_CHUNK;
+    WorkloadChunk *chunks = (WorkloadChunk *)checkedRealloc(NULL, sizeof(WorkloadChunk) * (*num_chunks > 0 ? *num_chunks : 1));
+    for (long long c = 0; c < *num_chunks; c++) {
+        chunks[c].spec = spec;
+        chunks[c].seed = seed;
+        chunks[c].chunk = c;
+        chunks[c].count = (int)((num_processes - c * WORKLOAD_CHUNK < WORKLOAD_CHUNK) ? num_processes - c * WORKLOAD_CHUNK : WORKLOAD_CHUNK);
+        chunks[c].processes = NULL;
+        chunks[c].records = NULL;
+        threadPoolSubmit(pool, workloadSumChunk, &chunks[c]);
+    }
+    threadPoolWait(pool);
+
+    long long offset = 0;
+    for (long long c = 0; c < *num_chunks; c++) { // 按块号顺序求前缀和
+        chunks[c].offset = offset;
+        offset += chunks[c].gap_sum;
+    }
+    if ((offset >> WORKLOAD_FIXED_SHIFT) > INT_MAX - WORKLOAD_MAX_BURST) {
+        printf("到达时间超出范围，请减小进程数或平均到达间隔\n");
+        exit(EXIT_FAILURE);
+    }
+    return chunks;
+}
+
+// 函数：按分布生成进程到内存，相同种子和参数总是生成相同数据
+void generateWorkload(PCB processes[], int num_processes, const WorkloadSpec *spec,
+                      unsigned long long seed, int num_threads) {
+    ThreadPool pool;
+    threadPoolInit(&pool, num_threads);
+    long long num_chunks;
+    WorkloadChunk *chunks = planWorkloadChunks(spec, num_processes, seed, &pool, &num_chunks);
+    for (long long c = 0; c < num_chunks; c++) {
+        chunks[c].processes = processes + c * WORKLOAD_CHUNK;
+        threadPoolSubmit(&pool, workloadFillChunk, &chunks[c]);
+    }
+    threadPoolWait(&pool);
+    threadPoolDestroy(&pool);
+    free(chunks);
+}
+
+// 函数：按分布生成进程并写成二进制轨迹文件，失败返回 0
+int generateTraceFile(const char *path, long long num_processes, const WorkloadSpec *spec,
+                      unsigned long long seed, int num_threads) {
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        perror(path);
+        return 0;
+    }
+    ThreadPool pool;
+    threadPoolInit(&pool, num_threads);
+    long long num_chunks;
+    WorkloadChunk *chunks = planWorkloadChunks(spec, num_processes, seed, &pool, &num_chunks);
+
+    // 每批并行生成若干块到各自的缓冲区，再按块号顺序写出
+    unsigned char *buffer = (unsigned char *)checkedRealloc(NULL, (size_t)WORKLOAD_BATCH_CHUNKS * WORKLOAD_CHUNK * TRACE_RECORD_SIZE);
+    int ok = (fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LEN, fp) == TRACE_MAGIC_LEN);
+    for (long long first = 0; ok && first < num_chunks; first += WORKLOAD_BATCH_CHUNKS) {
+        long long last = (first + WORKLOAD_BATCH_CHUNKS < num_chunks) ? first + WORKLOAD_BATCH_CHUNKS : num_chunks;
+        size_t bytes = 0;
+        for (long long c = first; c < last; c++) {
+            chunks[c].records = buffer + bytes;
+            bytes += (size_t)chunks[c].count * TRACE_RECORD_SIZE;
+            threadPoolSubmit(&pool, workloadFillChunk, &chunks[c]);
+        }
+        threadPoolWait(&pool);
+        ok = (fwrite(buffer, 1, bytes, fp) == bytes);
+    }
+    if (fclose(fp) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        perror(path);
+    }
+    free(buffer);
+    threadPoolDestroy(&pool);
+    free(chunks);
+    return ok;
+}
+
+// 函数：解析 "uniform:均值" 或 "poisson:均值"，失败返回 0
+int parseArrivalSpec(const char *text, WorkloadSpec *spec) {
+    if (sscanf(text, "uniform:%lf", &spec->mean_interarrival) == 1) {
+        spec->arrival = ARRIVAL_UNIFORM;
+    } else if (sscanf(text, "poisson:%lf", &spec->mean_interarrival) == 1) {
+        spec->arrival = ARRIVAL_POISSON;
+    } else {
+        return 0;
+    }
+    return spec->mean_interarrival >= 0;
+}
+
+// 函数：解析 "uniform:最小,最大"、"pareto:形状,最小值" 或 "lognormal:mu,sigma"，失败返回 0
+int parseBurstSpec(const char *text, WorkloadSpec *spec) {
+    if (sscanf(text, "uniform:%lf,%lf", &spec->burst_a, &spec->burst_b) == 2) {
+        spec->burst = BURST_UNIFORM;
+        return spec->burst_a >= 1 && spec->burst_b >= spec->burst_a;
+    }
+    if (sscanf(text, "pareto:%lf,%lf", &spec->burst_a, &spec->burst_b) == 2) {
+        spec->burst = BURST_PARETO;
+        return spec->burst_a > 0 && spec->burst_b > 0;
+    }
+    if (sscanf(text, "lognormal:%lf,%lf", &spec->burst_a, &spec->burst_b) == 2) {
+        spec->burst = BURST_LOGNORMAL;
+        return spec->burst_b >= 0;
+    }
+    return 0;
+}
+
+// --- 多 CPU (SMP) 模拟 ---
+// 每个 CPU 有自己的就绪集合（同一调度策略的独立实例）和正在运行的进程。
+// 新到达的进程有亲和性提示时放到提示的 CPU 上，否则放到负载（就绪数 + 运行数）最轻的 CPU 上。
+// 开启工作窃取时，本地就绪集合为空的空闲 CPU 从就绪进程最多的 CPU 取走其下一个将运行的进程；
+// 亲和性只是提示，窃取时照样迁移。
+// 每个时刻分三步：串行接纳到达的进程和 I/O 完成的进程；各 CPU 处理本地事件、检查抢占并从本地就绪集合调度，
+// 这一步只访问本 CPU 的数据和本 CPU 上的进程，可在线程池上并行；最后串行汇总完成的进程、
+// 把转入 I/O 的进程交给设备并窃取。
+// 结果与线程数无关。
+#define SMP_PARALLEL_MIN_CPUS 32 // 同一时刻需要处理的 CPU 达到此数量才分发到线程池，否则同步开销大于收益
+
+typedef struct {
+    void *ready;          // 本地就绪集合
+    int num_ready;        // 本地就绪进程数
+    int running;          // 正在运行的进程，-1 表示空闲
+    int dispatch_time;    // 正在运行进程本次被分派的时间
+    int run_length;       // 正在运行进程本次计划运行的时间
+    int event_time;       // 正在运行进程完成或时间片到期的时间
+    int event_complete;   // 1 为完成事件，0 为时间片到期
+    int touched;          // 本时刻是否有新进程放入
+    int finished;         // 本时刻完成（或转入 I/O）的进程，-1 表示无
+    long long busy_time;  // 累计运行时间
+    long long migrations; // 在本 CPU 上运行、上次却在其他 CPU 上运行的次数
+    long long dispatches; // 分派次数
+    int last;             // 上一个在本 CPU 上运行的进程
+    long long switches;   // 上下文切换次数
+    long long switch_time; // 上下文切换占用的时间
+} SmpCpu;
+
+typedef struct {
+    Simulation *sim;
+    const SchedPolicy *policy;
+    SmpCpu *cpus;
+    int num_cpus;
+    int work_stealing;    // 是否开启工作窃取
+    long long steals;     // 工作窃取次数
+    ThreadPool *pool;     // 并行处理各 CPU 的线程池，NULL 表示串行
+} SmpSystem;
+
+// 并行步骤的一个任务：一段需要处理的 CPU
+typedef struct {
+    SmpSystem *smp;
+    const int *cpu_ids;
+    int count;
+} SmpChunk;
+
+// 函数：在 CPU c 上运行进程 idx，登记其完成或时间片到期时间
+void smpDispatch(SmpSystem *smp, int c, int idx) {
+    SmpCpu *cpu = &smp->cpus[c];
+    Simulation *sim = smp->sim;
+    PCB *p = &sim->processes[idx];
+    p->state = 'R'; // 设置为运行状态
+    if (p->cpu != -1 && p->cpu != c) {
+        cpu->migrations++;
+    }
+    cpu->dispatches++;
+    p->cpu = c;
+    int overhead = 0; // 换上不同的进程时先付出切换开销
+    if (cpu->last != -1 && cpu->last != idx) {
+        cpu->switches++;
+        overhead = sim->switch_cost;
+        cpu->switch_time += overhead;
+    }
+    cpu->last = idx;
+    if (p->start_time == -1) {
+        p->start_time = sim->current_time + overhead; // 记录开始时间
+    }
+
+    int slice = (smp->policy->time_slice != NULL) ? smp->policy->time_slice(cpu->ready, sim->processes, idx) : 0;
+    cpu->running = idx;
+    cpu->dispatch_time = sim->current_time + overhead;
+    cpu->event_complete = !(slice > 0 && p->remaining_time > slice);
+    cpu->run_length = cpu->event_complete ? p->remaining_time : slice;
+    cpu->event_time = cpu->dispatch_time + cpu->run_length;
+}
+
+// 函数：处理 CPU c 在当前时刻的本地事件，并在空闲时从本地就绪集合调度
+void smpCpuStep(SmpSystem *smp, int c) {
+    SmpCpu *cpu = &smp->cpus[c];
+    Simulation *sim = smp->sim;
+    const SchedPolicy *policy = smp->policy;
+    PCB *processes = sim->processes;
+
+    cpu->finished = -1;
+    if (cpu->running != -1 && cpu->event_time == sim->current_time) {
+        int idx = cpu->running;
+        cpu->busy_time += cpu->run_length;
+        if (cpu->event_complete && processes[idx].burst_index + 1 < processes[idx].num_bursts) {
+            blockProcess(policy, cpu->ready, processes, idx, cpu->run_length);
+            cpu->finished = idx; // CPU 区间结束，由串行步骤交给设备
+        } else if (cpu->event_complete) {
+            PCB *p = &processes[idx];
+            p->remaining_time -= cpu->run_length; // 扣除本次运行时间
+            p->state = 'F'; // 设置为完成状态
+            p->finish_time = sim->current_time; // 记录完成时间
+            p->turnaround_time = p->finish_time - p->arrival_time; // 计算周转时间
+            if (policy->on_complete != NULL) {
+                policy->on_complete(cpu->ready, processes, idx);
+            }
+            cpu->finished = idx; // 由串行步骤汇总
+        } else { // 时间片到期，放回本地就绪集合
+            preemptProcess(policy, cpu->ready, processes, idx, cpu->run_length);
+            cpu->num_ready++;
+        }
+        cpu->running = -1;
+    }
+    if (cpu->running != -1 && policy->should_preempt != NULL) {
+        int ran = sim->current_time - cpu->dispatch_time;
+        if (policy->should_preempt(cpu->ready, processes, cpu->running, ran > 0 ? ran : 0)) {
+            if (ran < 0) { // 切换尚未完成即被抢占，未用完的切换时间不计
+                cpu->switch_time += ran;
+                ran = 0;
+            }
+            cpu->busy_time += ran;
+            preemptProcess(policy, cpu->ready, processes, cpu->running, ran);
+            cpu->num_ready++;
+            cpu->running = -1;
+        }
+    }
+    if (cpu->running == -1) {
+        int idx = policy->pick_next(cpu->ready, processes, sim->current_time);
+        if (idx != -1) {
+            cpu->num_ready--;
+            smpDispatch(smp, c, idx);
+        }
+    }
+}
+
+void smpRunChunk(void *arg) {
+    SmpChunk *chunk = (SmpChunk *)arg;
+    for (int i = 0; i < chunk->count; i++) {
+        smpCpuStep(chunk->smp, chunk->cpu_ids[i]);
+    }
+}
+
+// 函数：为新到达的进程选择 CPU
+int smpPlace(const SmpSystem *smp, const PCB *p) {
+    if (p->affinity >= 0) {
+        return p->affinity % smp->num_cpus;
+    }
+    int best = 0, best_load = -1;
+    for (int c = 0; c < smp->num_cpus; c++) {
+        int load = smp->cpus[c].num_ready + (smp->cpus[c].running != -1);
+        if (best_load == -1 || load < best_load) {
+            best = c;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// 函数：空闲 CPU 从就绪进程最多的 CPU 窃取进程
+void smpSteal(SmpSystem *smp) {
+    for (int c = 0; c < smp->num_cpus; c++) {
+        SmpCpu *cpu = &smp->cpus[c];
+        if (cpu->running != -1) {
+            continue;
+        }
+        int victim = -1;
+        for (int v = 0; v < smp->num_cpus; v++) {
+            if (smp->cpus[v].num_ready > 0 && (victim == -1 || smp->cpus[v].num_ready > smp->cpus[victim].num_ready)) {
+                victim = v;
+            }
+        }
+        if (victim == -1) {
+            return; // 所有 CPU 都没有就绪进程
+        }
+        SmpCpu *from = &smp->cpus[victim];
+        PCB *processes = smp->sim->processes;
+        int idx = smp->policy->pick_next(from->ready, processes, smp->sim->current_time);
+        from->num_ready--;
+        if (smp->policy->on_migrate != NULL) {
+            smp->policy->on_migrate(from->ready, cpu->ready, processes, idx);
+        }
+        smp->policy->enqueue(cpu->ready, processes, idx);
+        smp->steals++;
+        smpDispatch(smp, c, smp->policy->pick_next(cpu->ready, processes, smp->sim->current_time));
+    }
+}
+
+// 函数：打印每个 CPU 正在运行的进程
+void smpPrintStatus(const SmpSystem *smp) {
+    printf("时间 %-6d", smp->sim->current_time);
+    for (int c = 0; c < smp->num_cpus; c++) {
+        int idx = smp->cpus[c].running;
+        printf(" CPU%d: %-8s", c, idx == -1 ? "空闲" : smp->sim->processes[idx].name);
+    }
+    printf("\n");
+}
+
+// 函数：在 num_cpus 个 CPU 上用指定调度策略运行一次模拟
+void runSmpSimulation(SmpSystem *smp, Simulation *sim, const SchedPolicy *policy,
+                      int num_cpus, int work_stealing, ThreadPool *pool) {
+    smp->sim = sim;
+    smp->policy = policy;
+    smp->num_cpus = num_cpus;
+    smp->work_stealing = work_stealing;
+    smp->steals = 0;
+    smp->pool = pool;
+    smp->cpus = (SmpCpu *)checkedRealloc(NULL, sizeof(SmpCpu) * num_cpus);
+    for (int c = 0; c < num_cpus; c++) {
+        memset(&smp->cpus[c], 0, sizeof(SmpCpu));
+        smp->cpus[c].ready = policy->create(sim);
+        smp->cpus[c].running = -1;
+        smp->cpus[c].finished = -1;
+        smp->cpus[c].last = -1;
+    }
+    int *active = (int *)checkedRealloc(NULL, sizeof(int) * num_cpus); // 本时刻需要处理的 CPU
+    int num_chunks = (pool != NULL) ? pool->num_threads : 1;
+    SmpChunk *chunks = (SmpChunk *)checkedRealloc(NULL, sizeof(SmpChunk) * num_chunks);
+
+    int pending = simNextArrival(sim); // 下一个到达的进程
+    int live_processes = (pending != -1); // 已到达（或已取出待到达）但未完成的进程数
+
+    while (live_processes > 0) {
+        // 时钟跳到下一个到达、CPU 事件或 I/O 完成的时刻
+        int now = (pending != -1) ? sim->processes[pending].arrival_time : -1;
+        for (int c = 0; c < num_cpus; c++) {
+            if (smp->cpus[c].running != -1 && (now == -1 || smp->cpus[c].event_time < now)) {
+                now = smp->cpus[c].event_time;
+            }
+        }
+        for (int d = 0; d < sim->num_devices; d++) {
+            if (sim->devices[d].busy != -1 && (now == -1 || sim->devices[d].finish_time < now)) {
+                now = sim->devices[d].finish_time;
+            }
+        }
+        sim->current_time = now;
+
+        // 接纳到达的进程
+        while (pending != -1 && sim->processes[pending].arrival_time == now) {
+            SmpCpu *cpu = &smp->cpus[smpPlace(smp, &sim->processes[pending])];
+            policy->enqueue(cpu->ready, sim->processes, pending);
+            cpu->num_ready++;
+            cpu->touched = 1;
+            pending = simNextArrival(sim); // 可能扩容进程表
+            if (pending != -1) {
+                live_processes++;
+            }
+        }
+
+        // I/O 完成的进程回到就绪状态，与新到达的进程一样选择 CPU
+        for (int d = 0; d < sim->num_devices; d++) {
+            if (sim->devices[d].busy == -1 || sim->devices[d].finish_time != now) {
+                continue;
+            }
+            int idx = simFinishIo(sim, d);
+            PCB *p = &sim->processes[idx];
+            int target = smpPlace(smp, p);
+            SmpCpu *cpu = &smp->cpus[target];
+            if (p->cpu != -1 && p->cpu != target && policy->on_migrate != NULL) {
+                policy->on_migrate(smp->cpus[p->cpu].ready, cpu->ready, sim->processes, idx);
+            }
+            policy->enqueue(cpu->ready, sim->processes, idx);
+            cpu->num_ready++;
+            cpu->touched = 1;
+        }
+
+        // 各 CPU 处理本地事件并调度
+        int num_active = 0;
+        for (int c = 0; c < num_cpus; c++) {
+            SmpCpu *cpu = &smp->cpus[c];
+            if (cpu->touched || (cpu->running != -1 && cpu->event_time == now)) {
+                active[num_active++] = c;
+                cpu->touched = 0;
+            }
+        }
+        if (pool != NULL && num_active >= SMP_PARALLEL_MIN_CPUS) {
+            int per_chunk = (num_active + num_chunks - 1) / num_chunks;
+            for (int k = 0; k < num_chunks && k * per_chunk < num_active; k++) {
+                chunks[k].smp = smp;
+                chunks[k].cpu_ids = active + k * per_chunk;
+                chunks[k].count = (num_active - k * per_chunk < per_chunk) ? num_active - k * per_chunk : per_chunk;
+                threadPoolSubmit(pool, smpRunChunk, &chunks[k]);
+            }
+            threadPoolWait(pool);
+        } else {
+            for (int i = 0; i < num_active; i++) {
+                smpCpuStep(smp, active[i]);
+            }
+        }
+
+        // 汇总完成的进程和转入 I/O 的进程（按 CPU 编号顺序，结果与并行方式无关）
+        for (int i = 0; i < num_active; i++) {
+            SmpCpu *cpu = &smp->cpus[active[i]];
+            if (cpu->finished == -1) {
+                continue;
+            }
+            if (sim->processes[cpu->finished].state == 'B') {
+                simStartIo(sim, cpu->finished);
+            } else {
+                simRecordCompletion(sim, cpu->finished);
+                live_processes--;
+            }
+            cpu->finished = -1;
+        }
+
+        if (work_stealing) {
+            smpSteal(smp);
+        }
+        if (sim->verbosity >= VERBOSITY_STATUS) {
+            smpPrintStatus(smp);
+        }
+    }
+
+    for (int c = 0; c < num_cpus; c++) {
+        sim->dispatches += smp->cpus[c].dispatches;
+        sim->context_switches += smp->cpus[c].switches;
+        sim->switch_time += smp->cpus[c].switch_time;
+        sim->busy_time += smp->cpus[c].busy_time;
+        policy->destroy(smp->cpus[c].ready);
+    }
+    free(chunks);
+    free(active);
+}
+
+// 函数：输出各 CPU 利用率、迁移次数和平均周转时间
+void printSmpResult(const SmpSystem *smp) {
+    Simulation *sim = smp->sim;
+    if (sim->verbosity < VERBOSITY_RESULT) {
+        return;
+    }
+    long long migrations = 0;
+    double total_utilization = 0;
+    printf("CPU 利用率:");
+    for (int c = 0; c < smp->num_cpus; c++) {
+        double utilization = sim->current_time > 0 ?
+            100.0 * (smp->cpus[c].busy_time + smp->cpus[c].switch_time) / sim->current_time : 0;
+        total_utilization += utilization;
+        migrations += smp->cpus[c].migrations;
+        printf("%s CPU%d %.1f%%", (c % 8 == 0 && c > 0) ? "\n          " : "", c, utilization);
+    }
+    printf("\n平均 CPU 利用率: %.1f%%，迁移次数: %lld，工作窃取次数: %lld\n",
+           total_utilization / smp->num_cpus, migrations, smp->steals);
+    if (sim->streaming) {
+        printf("共 %lld 个进程，最大同时存活 %d 个\n", sim->completed, sim->num_processes);
+    }
+    printf("%s 平均周转时间: %.2f\n", smp->policy->name, simAverageTurnaround(sim));
+    printCpuEfficiency(sim, (long long)sim->current_time * smp->num_cpus);
+    printDeviceUtilization(sim);
+    printLatencyStats(&sim->latency);
+}
+
+// 函数：在多个 CPU 上依次运行所有调度算法，每种算法分别开启和关闭工作窃取
+void runSmpAllAlgorithms(const Workload *workload, const SimOptions *options, int num_cpus, int num_threads) {
+    ThreadPool pool;
+    ThreadPool *pool_ptr = NULL;
+    if (num_threads > 1 && num_cpus >= SMP_PARALLEL_MIN_CPUS) {
+        threadPoolInit(&pool, num_threads);
+        pool_ptr = &pool;
+    }
+    const SchedPolicy *policies[MAX_WORKLOAD_POLICIES];
+    int num_policies = workloadPolicies(workload, policies);
+    for (int i = 0; i < num_policies; i++) {
+        for (int work_stealing = 1; work_stealing >= 0; work_stealing--) {
+            Simulation sim;
+            if (!simInit(&sim, workload)) {
+                break;
+            }
+            simApplyOptions(&sim, options);
+            const SchedPolicy *policy = policies[i];
+            if (sim.verbosity >= VERBOSITY_RESULT) {
+                printf("\n\n=== %s 调度 (%d 个 CPU，%s", policy->title, num_cpus, work_stealing ? "工作窃取" : "无工作窃取");
+                if (policy->uses_time_slice) {
+                    printf("，时间片: %d", sim.time_slice);
+                }
+                printf(") ===\n");
+            }
+            SmpSystem smp;
+            runSmpSimulation(&smp, &sim, policy, num_cpus, work_stealing, pool_ptr);
+            printSmpResult(&smp);
+            free(smp.cpus);
+            simFree(&sim);
+        }
+    }
+    if (pool_ptr != NULL) {
+        threadPoolDestroy(pool_ptr);
+    }
+}
+
+// --- 参数扫描 ---
+// 对 (种子, 进程数) 的每个组合生成一份工作负载，在同一份数据上运行所有调度策略，
+// 使用时间片的策略在每个时间片下各运行一次，统计各算法平均周转时间在所有种子上的均值、p50 和 p99。
+static const int sweep_process_counts[] = {10, 100, 1000, 10000};
+static const int sweep_time_slices[] = {1, 2, 4, 8};
+#define SWEEP_NUM_COUNTS ((int)(sizeof(sweep_process_counts) / sizeof(sweep_process_counts[0])))
+#define SWEEP_NUM_SLICES ((int)(sizeof(sweep_time_slices) / sizeof(sweep_time_slices[0])))
+#define SWEEP_MAX_VARIANTS (NUM_POLICIES * SWEEP_NUM_SLICES) // 算法配置数的上限
+
+// 一种算法配置：调度策略及其时间片
+typedef struct {
+    const SchedPolicy *policy;
+    int time_slice;
+} SweepVariant;
+
+static SweepVariant sweep_variants[SWEEP_MAX_VARIANTS];
+static int sweep_num_variants = 0;
+
+// 函数：列出所有算法配置，在启动工作线程前调用
+void buildSweepVariants(void) {
+    sweep_num_variants = 0;
+    for (int i = 0; i < NUM_POLICIES; i++) {
+        int slices = scheduling_policies[i]->uses_time_slice ? SWEEP_NUM_SLICES : 1;
+        for (int q = 0; q < slices; q++) {
+            sweep_variants[sweep_num_variants].policy = scheduling_policies[i];
+            sweep_variants[sweep_num_variants].time_slice = scheduling_policies[i]->uses_time_slice ? sweep_time_slices[q] : TIME_SLICE;
+            sweep_num_variants++;
+        }
+    }
+}
+
+typedef struct {
+    unsigned long long seed;  // 随机种子
+    int num_processes;        // 进程数
+    double avg_turnaround[SWEEP_MAX_VARIANTS]; // 各算法配置的平均周转时间
+} SweepTask;
+
+// 函数：运行一组配置（在工作线程中执行，只访问自己的任务数据）
+void runSweepTask(void *arg) {
+    SweepTask *task = (SweepTask *)arg;
+    PCB *processes = (PCB *)checkedRealloc(NULL, sizeof(PCB) * task->num_processes);
+    initializeProcesses(processes, task->num_processes, task->seed);
+
+    for (int a = 0; a < sweep_num_variants; a++) {
+        Simulation sim;
+        simInitProcesses(&sim, processes, task->num_processes);
+        sim.verbosity = VERBOSITY_SILENT;
+        sim.time_slice = sweep_variants[a].time_slice;
+        runSimulation(&sim, sweep_variants[a].policy);
+        task->avg_turnaround[a] = simAverageTurnaround(&sim);
+        simFree(&sim);
+    }
+    free(processes);
+}
+
+int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// 函数：已排序数组的百分位数（最近秩法）
+double percentile(const double sorted[], int n, double p) {
+    int rank = (int)(p * n + 0.999999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > n ? n : rank) - 1];
+}
+
+void runSweep(int num_seeds, int num_threads) {
+    int num_tasks = num_seeds * SWEEP_NUM_COUNTS;
+    SweepTask *tasks = (SweepTask *)checkedRealloc(NULL, sizeof(SweepTask) * num_tasks);
+    buildSweepVariants();
+    printf("参数扫描: %d 个种子 x %d 种进程数 x %d 种算法配置，共 %d 组配置，%d 个线程\n",
+           num_seeds, SWEEP_NUM_COUNTS, sweep_num_variants, num_seeds * SWEEP_NUM_COUNTS * sweep_num_variants, num_threads);
+
+    ThreadPool pool;
+    threadPoolInit(&pool, num_threads);
+    for (int c = SWEEP_NUM_COUNTS - 1; c >= 0; c--) { // 先提交规模大的任务，便于负载均衡
+        for (int s = 0; s < num_seeds; s++) {
+            SweepTask *task = &tasks[c * num_seeds + s];
+            task->seed = (unsigned long long)s + 1;
+            task->num_processes = sweep_process_counts[c];
+            threadPoolSubmit(&pool, runSweepTask, task);
+        }
+    }
+    threadPoolWait(&pool);
+    threadPoolDestroy(&pool);
+
+    printf("\n%-13s%-14s%-16s%-14s%-14s\n", "进程数", "算法", "平均", "p50", "p99");
+    double *values = (double *)checkedRealloc(NULL, sizeof(double) * num_seeds);
+    for (int c = 0; c < SWEEP_NUM_COUNTS; c++) {
+        for (int a = 0; a < sweep_num_variants; a++) {
+            double sum = 0;
+            for (int s = 0; s < num_seeds; s++) {
+                values[s] = tasks[c * num_seeds + s].avg_turnaround[a];
+                sum += values[s];
+            }
+            qsort(values, num_seeds, sizeof(double), compareDouble);
+            char name[16];
+            if (sweep_variants[a].policy->uses_time_slice) {
+                snprintf(name, sizeof(name), "%s(q=%d)", sweep_variants[a].policy->name, sweep_variants[a].time_slice);
+            } else {
+                snprintf(name, sizeof(name), "%s", sweep_variants[a].policy->name);
+            }
+            printf("%-10d%-12s%-14.2f%-14.2f%-14.2f\n", sweep_process_counts[c], name,
+                   sum / num_seeds, percentile(values, num_seeds, 0.50), percentile(values, num_seeds, 0.99));
+        }
+    }
+    free(values);
+    free(tasks);
+}
+
+// --- RR 时间片自动调优 ---
+// 在给定工作负载（生成的进程、轨迹文件或周期任务集）和切换开销下搜索使 RR 平均周转时间最小的时间片。
+// 先在 1 到最大运行时间之间按约 1.5 倍的几何间隔取点，之后反复在当前最优点两侧相邻的已评估点之间
+// 均匀取 TUNE_POINTS 个点，直到区间内的整数全部评估过。每轮的候选时间片在线程池上并行模拟；
+// 取点方式与线程数无关，相同平均周转时间取较小的时间片，结果确定。
+#define TUNE_POINTS 16 // 每轮细化的取点数
+
+typedef struct {
+    const Workload *workload; // 工作负载
+    int switch_cost;         // 上下文切换开销
+    int time_slice;          // 待评估的时间片
+    double avg_turnaround;   // 结果：平均周转时间
+    long long context_switches; // 结果：上下文切换次数
+    double efficiency;       // 结果：CPU 效率
+    double throughput;       // 结果：吞吐量
+} TuneTask;
+
+void runTuneTask(void *arg) {
+    TuneTask *task = (TuneTask *)arg;
+    Simulation sim;
+    if (!simInit(&sim, task->workload)) {
+        exit(EXIT_FAILURE);
+    }
+    sim.verbosity = VERBOSITY_SILENT;
+    sim.time_slice = task->time_slice;
+    sim.switch_cost = task->switch_cost;
+    runSimulation(&sim, &rr_policy);
+    task->avg_turnaround = simAverageTurnaround(&sim);
+    task->context_switches = sim.context_switches;
+    long long occupied = sim.busy_time + sim.switch_time;
+    task->efficiency = occupied > 0 ? 100.0 * sim.busy_time / occupied : 100.0;
+    task->throughput = sim.current_time > 0 ? (double)sim.completed / sim.current_time : 0.0;
+    simFree(&sim);
+}
+
+int compareTuneTask(const void *a, const void *b) {
+    return ((const TuneTask *)a)->time_slice - ((const TuneTask *)b)->time_slice;
+}
+
+// 函数：工作负载中的最大运行时间，即有意义的时间片上限
+int maxBurstTime(const Workload *workload) {
+    int max_burst = 1;
+    if (workload->task_set != NULL) {
+        for (int i = 0; i < workload->task_set->count; i++) {
+            int wcet = workload->task_set->tasks[i].wcet;
+            max_burst = wcet > max_burst ? wcet : max_burst;
+        }
+        return max_burst;
+    }
+    if (workload->trace_path == NULL) {
+        for (int i = 0; i < workload->num_processes; i++) {
+            int burst_time = workload->processes[i].burst_time;
+            max_burst = burst_time > max_burst ? burst_time : max_burst;
+        }
+        return max_burst;
+    }
+    TraceReader tr;
+    if (!traceOpen(&tr, workload->trace_path)) {
+        exit(EXIT_FAILURE);
+    }
+    PCB record;
+    while (traceNext(&tr, &record)) {
+        for (int k = 0; k < record.num_bursts; k += 2) { // 只看 CPU 区间
+            int burst_time = record.bursts != NULL ? record.bursts[k].length : record.burst_time;
+            max_burst = burst_time > max_burst ? burst_time : max_burst;
+        }
+        free(record.bursts);
+    }
+    traceClose(&tr);
+    return max_burst;
+}
+
+// 函数：在已评估的时间片中查找 q，未评估返回 -1
+int findTuneTask(const TuneTask *tasks, int count, int q) {
+    for (int i = 0; i < count; i++) {
+        if (tasks[i].time_slice == q) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void runSliceTuning(const Workload *workload, int switch_cost, int num_threads) {
+    int max_slice = maxBurstTime(workload); // 时间片不小于最大运行时间时等同先来先服务
+    int capacity = 64, count = 0;
+    TuneTask *tasks = (TuneTask *)checkedRealloc(NULL, sizeof(TuneTask) * capacity);
+    int *candidates = (int *)checkedRealloc(NULL, sizeof(int) * (TUNE_POINTS + 64));
+    ThreadPool pool;
+    threadPoolInit(&pool, num_threads);
+
+    // 第一轮：几何间隔
+    int num_candidates = 0;
+    for (double q = 1; ; q = q * 1.5 + 0.5) {
+        int slice = (int)q < max_slice ? (int)q : max_slice;
+        if (num_candidates == 0 || candidates[num_candidates - 1] != slice) {
+            candidates[num_candidates++] = slice;
+        }
+        if (slice == max_slice) {
+            break;
+        }
+    }
+
+    int rounds = 0;
+    while (num_candidates > 0) {
+        rounds++;
+        if (count + num_candidates > capacity) {
+            capacity = (count + num_candidates) * 2;
+            tasks = (TuneTask *)checkedRealloc(tasks, sizeof(TuneTask) * capacity);
+        }
+        for (int i = 0; i < num_candidates; i++) {
+            TuneTask *task = &tasks[count + i];
+            task->workload = workload;
+            task->switch_cost = switch_cost;
+            task->time_slice = candidates[i];
+        }
+        for (int i = 0; i < num_candidates; i++) {
+            threadPoolSubmit(&pool, runTuneTask, &tasks[count + i]);
+        }
+        threadPoolWait(&pool);
+        count += num_candidates;
+        qsort(tasks, count, sizeof(TuneTask), compareTuneTask);
+
+        // 当前最优点及其两侧相邻的已评估点
+        int best = 0;
+        for (int i = 1; i < count; i++) {
+            if (tasks[i].avg_turnaround < tasks[best].avg_turnaround) {
+                best = i;
+            }
+        }
+        int lo = best > 0 ? tasks[best - 1].time_slice : tasks[best].time_slice;
+        int hi = best + 1 < count ? tasks[best + 1].time_slice : tasks[best].time_slice;
+
+        // 下一轮：区间内均匀取点，跳过已评估的时间片
+        num_candidates = 0;
+        for (int k = 1; k <= TUNE_POINTS; k++) {
+            int q = lo + (int)((long long)(hi - lo) * k / (TUNE_POINTS + 1));
+            if (q > lo && q < hi && findTuneTask(tasks, count, q) == -1 &&
+                (num_candidates == 0 || candidates[num_candidates - 1] != q)) {
+                candidates[num_candidates++] = q;
+            }
+        }
+    }
+    threadPoolDestroy(&pool);
+
+    printf("RR 时间片调优：上下文切换开销 %d，最大运行时间 %d，%d 轮共评估 %d 个时间片，%d 个线程\n",
+           switch_cost, max_slice, rounds, count, num_threads);
+    printf("%-13s%-20s%-19s%-14s%s\n", "时间片", "平均周转时间", "上下文切换", "CPU 效率", "吞吐量");
+    int best = 0;
+    for (int i = 0; i < count; i++) {
+        printf("%-10d%-14.2f%-14lld%-12.1f%.4f\n", tasks[i].time_slice, tasks[i].avg_turnaround,
+               tasks[i].context_switches, tasks[i].efficiency, tasks[i].throughput);
+        if (tasks[i].avg_turnaround < tasks[best].avg_turnaround) {
+            best = i;
+        }
+    }
+    printf("最佳时间片: %d（平均周转时间 %.2f）\n", tasks[best].time_slice, tasks[best].avg_turnaround);
+    free(candidates);
+    free(tasks);
+}
+
+// --- 进程表布局基准测试 ---
+// 逐个扫描就绪进程的选择方式（不借助堆或锦标赛树）每次都要遍历全部进程，
+// 而一次扫描只用到状态、到达时间和运行时间。PCB 数组 (AoS) 中这些字段与进程名等交错存放，
+// 扫描时整条 PCB 都被读入缓存；结构数组 (SoA) 把各字段分别连续存放，进程名放在旁表中，
+// 扫描只读取需要的数组，并可用 SIMD 一次比较多个进程。
+// 两种扫描：最短运行时间（SJF 的暴力选择）和最高响应比（HRRF 的暴力选择，比值用单精度计算）。
+// 就绪条件：状态为 'W' 且已到达；相同值时下标小者优先。
+
+// 结构数组形式的进程表
+typedef struct {
+    int *arrival_time;        // 到达时间
+    int *burst_time;          // 运行时间
+    int *remaining_time;      // 剩余运行时间
+    unsigned char *state;     // 进程状态
+    char (*names)[10];        // 进程名旁表，扫描时不访问
+    int count;
+} ProcessTable;
+
+void processTableFromPCB(ProcessTable *pt, const PCB processes[], int num_processes) {
+    pt->count = num_processes;
+    pt->arrival_time = (int *)checkedRealloc(NULL, sizeof(int) * num_processes);
+    pt->burst_time = (int *)checkedRealloc(NULL, sizeof(int) * num_processes);
+    pt->remaining_time = (int *)checkedRealloc(NULL, sizeof(int) * num_processes);
+    pt->state = (unsigned char *)checkedRealloc(NULL, num_processes);
+    pt->names = (char (*)[10])checkedRealloc(NULL, sizeof(pt->names[0]) * num_processes);
+    for (int i = 0; i < num_processes; i++) {
+        pt->arrival_time[i] = processes[i].arrival_time;
+        pt->burst_time[i] = processes[i].burst_time;
+        pt->remaining_time[i] = processes[i].remaining_time;
+        pt->state[i] = (unsigned char)processes[i].state;
+        memcpy(pt->names[i], processes[i].name, sizeof(pt->names[i]));
+    }
+}
+
+void processTableFree(ProcessTable *pt) {
+    free(pt->arrival_time);
+    free(pt->burst_time);
+    free(pt->remaining_time);
+    free(pt->state);
+    free(pt->names);
+}
+
+// 函数：PCB 数组上选择运行时间最短的就绪进程，无则返回 -1
+int aosMinBurst(const PCB processes[], int num_processes, int current_time) {
+    int best = -1;
+    for (int i = 0; i < num_processes; i++) {
+        if (processes[i].state == 'W' && processes[i].arrival_time <= current_time &&
+            (best == -1 || processes[i].burst_time < processes[best].burst_time)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// 函数：PCB 数组上选择响应比最高的就绪进程，无则返回 -1
+int aosMaxRatio(const PCB processes[], int num_processes, int current_time) {
+    int best = -1;
+    float best_ratio = 0;
+    for (int i = 0; i < num_processes; i++) {
+        if (processes[i].state == 'W' && processes[i].arrival_time <= current_time) {
+            float ratio = (float)(current_time - processes[i].arrival_time + processes[i].burst_time) /
+                          (float)processes[i].burst_time;
+            if (best == -1 || ratio > best_ratio) {
+                best = i;
+                best_ratio = ratio;
+            }
+        }
+    }
+    return best;
+}
+
+// 结构数组上的扫描分两遍：第一遍无分支地求最值，第二遍找出取得最值的第一个下标
+int soaMinBurst(const ProcessTable *pt, int current_time) {
+    int min_burst = INT_MAX;
+    for (int i = 0; i < pt->count; i++) {
+        int ready = -((pt->state[i] == 'W') & (pt->arrival_time[i] <= current_time)); // 就绪时全 1
+        int burst = (pt->burst_time[i] & ready) | (INT_MAX & ~ready);
+        min_burst = burst < min_burst ? burst : min_burst;
+    }
+    if (min_burst == INT_MAX) {
+        return -1;
+    }
+    for (int i = 0; i < pt->count; i++) {
+        if (pt->state[i] == 'W' && pt->arrival_time[i] <= current_time && pt->burst_time[i] == min_burst) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int soaMaxRatio(const ProcessTable *pt, int current_time) {
+    float max_ratio = -1;
+    for (int i = 0; i < pt->count; i++) {
+        int ready = (pt->state[i] == 'W') & (pt->arrival_time[i] <= current_time);
+        float ratio = (float)(current_time - pt->arrival_time[i] + pt->burst_time[i]) / (float)pt->burst_time[i];
+        ratio = ratio * ready - (1 - ready); // 未就绪时为 -1，避免分支
+        max_ratio = ratio > max_ratio ? ratio : max_ratio;
+    }
+    if (max_ratio < 0) {
+        return -1;
+    }
+    for (int i = 0; i < pt->count; i++) {
+        if (pt->state[i] == 'W' && pt->arrival_time[i] <= current_time &&
+            (float)(current_time - pt->arrival_time[i] + pt->burst_time[i]) / (float)pt->burst_time[i] == max_ratio) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#ifdef __AVX2__
+// AVX2 版本：每次处理 8 个进程，剩余不足 8 个的尾部按标量处理
+
+// 函数：8 个进程的就绪掩码（每个 32 位通道全 1 表示就绪）
+static inline __m256i readyMask8(const ProcessTable *pt, int i, __m256i now, __m256i waiting) {
+    __m256i state = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(pt->state + i)));
+    __m256i arrival = _mm256_loadu_si256((const __m256i *)(pt->arrival_time + i));
+    return _mm256_andnot_si256(_mm256_cmpgt_epi32(arrival, now), _mm256_cmpeq_epi32(state, waiting));
+}
+
+static inline __m256 ratio8(const ProcessTable *pt, int i, __m256i now) {
+    __m256i arrival = _mm256_loadu_si256((const __m256i *)(pt->arrival_time + i));
+    __m256i burst = _mm256_loadu_si256((const __m256i *)(pt->burst_time + i));
+    __m256 response = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_sub_epi32(now, arrival), burst));
+    return _mm256_div_ps(response, _mm256_cvtepi32_ps(burst));
+}
+
+int simdMinBurst(const ProcessTable *pt, int current_time) {
+    __m256i now = _mm256_set1_epi32(current_time);
+    __m256i waiting = _mm256_set1_epi32('W');
+    __m256i none = _mm256_set1_epi32(INT_MAX);
+    __m256i vmin = none;
+    int i = 0;
+    for (; i + 8 <= pt->count; i += 8) {
+        __m256i burst = _mm256_loadu_si256((const __m256i *)(pt->burst_time + i));
+        __m256i ready = readyMask8(pt, i, now, waiting);
+        vmin = _mm256_min_epi32(vmin, _mm256_blendv_epi8(none, burst, ready));
+    }
+    int lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, vmin);
+    int min_burst = INT_MAX;
+    for (int k = 0; k < 8; k++) {
+        min_burst = lanes[k] < min_burst ? lanes[k] : min_burst;
+    }
+    for (int k = i; k < pt->count; k++) { // 尾部
+        if (pt->state[k] == 'W' && pt->arrival_time[k] <= current_time && pt->burst_time[k] < min_burst) {
+            min_burst = pt->burst_time[k];
+        }
+    }
+    if (min_burst == INT_MAX) {
+        return -1;
+    }
+
+    __m256i target = _mm256_set1_epi32(min_burst);
+    for (i = 0; i + 8 <= pt->count; i += 8) {
+        __m256i burst = _mm256_loadu_si256((const __m256i *)(pt->burst_time + i));
+        __m256i hit = _mm256_and_si256(readyMask8(pt, i, now, waiting), _mm256_cmpeq_epi32(burst, target));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < pt->count; i++) {
+        if (pt->state[i] == 'W' && pt->arrival_time[i] <= current_time && pt->burst_time[i] == min_burst) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int simdMaxRatio(const ProcessTable *pt, int current_time) {
+    __m256i now = _mm256_set1_epi32(current_time);
+    __m256i waiting = _mm256_set1_epi32('W');
+    __m256 none = _mm256_set1_ps(-1);
+    __m256 vmax = none;
+    int i = 0;
+    for (; i + 8 <= pt->count; i += 8) {
+        __m256 ready = _mm256_castsi256_ps(readyMask8(pt, i, now, waiting));
+        vmax = _mm256_max_ps(vmax, _mm256_blendv_ps(none, ratio8(pt, i, now), ready));
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, vmax);
+    float max_ratio = -1;
+    for (int k = 0; k < 8; k++) {
+        max_ratio = lanes[k] > max_ratio ? lanes[k] : max_ratio;
+    }
+    for (int k = i; k < pt->count; k++) { // 尾部
+        if (pt->state[k] == 'W' && pt->arrival_time[k] <= current_time) {
+            float ratio = (float)(current_time - pt->arrival_time[k] + pt->burst_time[k]) / (float)pt->burst_time[k];
+            max_ratio = ratio > max_ratio ? ratio : max_ratio;
+        }
+    }
+    if (max_ratio < 0) {
+        return -1;
+    }
+
+    __m256 target = _mm256_set1_ps(max_ratio);
+    for (i = 0; i + 8 <= pt->count; i += 8) {
+        __m256 hit = _mm256_and_ps(_mm256_castsi256_ps(readyMask8(pt, i, now, waiting)),
+                                   _mm256_cmp_ps(ratio8(pt, i, now), target, _CMP_EQ_OQ));
+        int mask = _mm256_movemask_ps(hit);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < pt->count; i++) {
+        if (pt->state[i] == 'W' && pt->arrival_time[i] <= current_time &&
+            (float)(current_time - pt->arrival_time[i] + pt->burst_time[i]) / (float)pt->burst_time[i] == max_ratio) {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif
+
+// 函数：单调时钟，单位秒
+double wallSeconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+#define LAYOUT_BENCH_ELEMENTS 100000000LL // 每种扫描累计处理的进程数，决定重复次数
+
+static const int layout_bench_counts[] = {100000, 1000000, 10000000};
+#define LAYOUT_BENCH_NUM_COUNTS ((int)(sizeof(layout_bench_counts) / sizeof(layout_bench_counts[0])))
+
+// 一种布局的一对扫描函数（通过包装统一签名）
+typedef struct {
+    const char *name;
+    int (*min_burst)(const PCB processes[], const ProcessTable *pt, int current_time);
+    int (*max_ratio)(const PCB processes[], const ProcessTable *pt, int current_time);
+} LayoutScanner;
+
+int benchAosMinBurst(const PCB processes[], const ProcessTable *pt, int t) { return aosMinBurst(processes, pt->count, t); }
+int benchAosMaxRatio(const PCB processes[], const ProcessTable *pt, int t) { return aosMaxRatio(processes, pt->count, t); }
+int benchSoaMinBurst(const PCB processes[], const ProcessTable *pt, int t) { (void)processes; return soaMinBurst(pt, t); }
+int benchSoaMaxRatio(const PCB processes[], const ProcessTable *pt, int t) { (void)processes; return soaMaxRatio(pt, t); }
+#ifdef __AVX2__
+int benchSimdMinBurst(const PCB processes[], const ProcessTable *pt, int t) { (void)processes; return simdMinBurst(pt, t); }
+int benchSimdMaxRatio(const PCB processes[], const ProcessTable *pt, int t) { (void)processes; return simdMaxRatio(pt, t); }
+#endif
+
+static const LayoutScanner layout_scanners[] = {
+    {"AoS", benchAosMinBurst, benchAosMaxRatio},
+    {"SoA", benchSoaMinBurst, benchSoaMaxRatio},
+#ifdef __AVX2__
+    {"SoA+AVX2", benchSimdMinBurst, benchSimdMaxRatio},
+#endif
+};
+#define NUM_LAYOUT_SCANNERS ((int)(sizeof(layout_scanners) / sizeof(layout_scanners[0])))
+
+// 函数：对一种扫描计时，返回每个进程的平均纳秒数；各次扫描的结果累加到 checksum 用于核对
+double timeScan(int (*scan)(const PCB[], const ProcessTable *, int), const PCB processes[],
+                const ProcessTable *pt, int repeats, long long *checksum) {
+    double start = wallSeconds();
+    for (int r = 0; r < repeats; r++) {
+        *checksum += scan(processes, pt, r % 12); // 时间在 0-11 之间变化，就绪集合随之变化
+    }
+    return (wallSeconds() - start) * 1e9 / ((double)repeats * pt->count);
+}
+
+// 函数：比较 PCB 数组与结构数组上的暴力扫描速度
+void runLayoutBenchmark(unsigned long long seed) {
+#ifndef __AVX2__
+    printf("未启用 AVX2（编译时加 -mavx2 或 -march=native），只比较标量扫描\n");
+#endif
+    printf("%-13s%-12s%-30s%s\n", "进程数", "布局", "最短运行时间 ns/进程", "最高响应比 ns/进程");
+    for (int c = 0; c < LAYOUT_BENCH_NUM_COUNTS; c++) {
+        int n = layout_bench_counts[c];
+        PCB *processes = (PCB *)checkedRealloc(NULL, sizeof(PCB) * n);
+        initializeProcesses(processes, n, seed);
+        Rng rng;
+        rngSeed(&rng, seed ^ 0x5DEECE66DULL);
+        for (int i = 0; i < n; i++) {
+            if (rngBelow(&rng, 2)) {
+                processes[i].state = 'F'; // 约一半进程已完成
+            }
+        }
+        ProcessTable pt;
+        processTableFromPCB(&pt, processes, n);
+
+        int repeats = (int)(LAYOUT_BENCH_ELEMENTS / n);
+        long long expected_min = 0, expected_ratio = 0;
+        for (int s = 0; s < NUM_LAYOUT_SCANNERS; s++) {
+            long long sum_min = 0, sum_ratio = 0;
+            double ns_min = timeScan(layout_scanners[s].min_burst, processes, &pt, repeats, &sum_min);
+            double ns_ratio = timeScan(layout_scanners[s].max_ratio, processes, &pt, repeats, &sum_ratio);
+            if (s == 0) {
+                expected_min = sum_min;
+                expected_ratio = sum_ratio;
+            } else if (sum_min != expected_min || sum_ratio != expected_ratio) {
+                printf("%s 扫描结果与 AoS 不一致\n", layout_scanners[s].name);
+                exit(EXIT_FAILURE);
+            }
+            printf("%-10d%-10s%-22.3f%.3f\n", n, layout_scanners[s].name, ns_min, ns_ratio);
+        }
+        processTableFree(&pt);
+        free(processes);
+    }
+}
+
+// --- 调度开销基准测试 ---
+// 不输出过程，在不同进程数下运行各调度策略，测量每次调度决策（分派）的平均耗时：
+// 事件内核的运行时间（不含复制进程表和排序到达流）除以分派次数。
+// 输出 CSV：策略、进程数、重复次数、分派次数、ns/分派、总耗时（秒）、进程内存峰值（KB）。
+// 进程数较小时重复运行直到累计时间达到 DISPATCH_BENCH_MIN_SECONDS；
+// 内存峰值是整个进程的最高值，进程数按从小到大运行，因此反映到当前规模为止的峰值。
+#define DISPATCH_BENCH_MIN_SECONDS 0.2
+
+static const int dispatch_bench_counts[] = {10, 1000, 100000, 1000000};
+#define DISPATCH_BENCH_NUM_COUNTS ((int)(sizeof(dispatch_bench_counts) / sizeof(dispatch_bench_counts[0])))
+
+// 函数：进程内存峰值 (KB)，无法获取时返回 -1
+long peakRssKb(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+    return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    return (long)(usage.ru_maxrss / 1024); // macOS 以字节为单位
+#else
+    return (long)usage.ru_maxrss;
+#endif
+#endif
+}
+
+void runDispatchBenchmark(unsigned long long seed) {
+    printf("policy,n,repeats,dispatches,ns_per_dispatch,wall_seconds,peak_rss_kb\n");
+    for (int c = 0; c < DISPATCH_BENCH_NUM_COUNTS; c++) {
+        int n = dispatch_bench_counts[c];
+        PCB *processes = (PCB *)checkedRealloc(NULL, sizeof(PCB) * n);
+        initializeProcesses(processes, n, seed);
+        for (int i = 0; i < NUM_POLICIES; i++) {
+            const SchedPolicy *policy = scheduling_policies[i];
+            long long dispatches = 0;
+            double sched_seconds = 0;
+            int repeats = 0;
+            double start = wallSeconds();
+            do {
+                Simulation sim;
+                simInitProcesses(&sim, processes, n);
+                sim.verbosity = VERBOSITY_SILENT;
+                double run_start = wallSeconds();
+                runSimulation(&sim, policy);
+                sched_seconds += wallSeconds() - run_start;
+                dispatches += sim.dispatches;
+                simFree(&sim);
+                repeats++;
+            } while (wallSeconds() - start < DISPATCH_BENCH_MIN_SECONDS);
+            double wall = wallSeconds() - start;
+            printf("%s,%d,%d,%lld,%.2f,%.6f,%ld\n", policy->name, n, repeats, dispatches,
+                   dispatches > 0 ? sched_seconds * 1e9 / dispatches : 0.0, wall, peakRssKb());
+            fflush(stdout);
+        }
+        free(processes);
+    }
+}
+
+void printUsage(const char *prog) {
+    printf("用法: %s [进程数] [--seed 种子]\n", prog);
+    printf("      %s --trace 轨迹文件 (CSV 或二进制)\n", prog);
+    printf("      %s --sweep [种子数] [--threads 线程数]\n", prog);
+    printf("      %s [进程数 | --trace 轨迹文件] --cpus CPU数 [--affinity] [--threads 线程数]\n", prog);
+    printf("      %s --bench-layout [--seed 种子]\n", prog);
+    printf("      %s --bench-dispatch [--seed 种子]\n", prog);
+    printf("      %s --tasks 任务文件 [--horizon 模拟时长] [--cpus CPU数]\n", prog);
+    printf("      %s [进程数 | --trace 轨迹文件] --tune-slice [--switch-cost 开销] [--threads 线程数]\n", prog);
+    printf("通用选项: --time-slice 时间片 --switch-cost 上下文切换开销\n");
+    printf("      %s 进程数 [--arrival uniform:均值|poisson:均值] [--burst uniform:最小,最大|pareto:形状,最小值|lognormal:mu,sigma]\n", prog);
+    printf("          [--gen-trace 输出文件] [--seed 种子] [--threads 线程数]\n");
+}
+
+int main(int argc, char *argv[]) {
+    int num_processes = MAX_PROCESSES; // 进程数，可由命令行参数指定
+    const char *trace_path = NULL;     // 轨迹文件路径
+    const char *task_path = NULL;      // 周期任务文件路径
+    int horizon = 0;                   // 周期任务集的模拟时长，0 表示按超周期确定
+    unsigned long long seed = (unsigned long long)time(NULL); // 默认使用当前时间作为随机数种子
+    int sweep_seeds = 0;               // 参数扫描的种子数，0 表示不扫描
+    int num_threads = onlineCpuCount(); // 参数扫描和多 CPU 模拟的线程数
+    int num_cpus = 0;                  // 模拟的 CPU 数，0 表示单 CPU 模拟
+    int affinity = 0;                  // 是否为随机生成的进程设置亲和性提示
+    int bench_layout = 0;              // 是否运行进程表布局基准测试
+    int bench_dispatch = 0;            // 是否运行调度开销基准测试
+    int tune_slice = 0;                // 是否自动调优 RR 时间片
+    SimOptions options = {VERBOSITY_RESULT, TIME_SLICE, 0}; // 模拟参数
+    WorkloadSpec spec = {ARRIVAL_UNIFORM, 5.0, BURST_UNIFORM, 5, 19}; // 工作负载分布
+    int use_spec = 0;                  // 是否按指定分布生成进程（否则使用实验默认的生成方式）
+    const char *gen_trace_path = NULL; // 生成的轨迹文件路径
+    long long gen_count = 0;           // 生成轨迹的进程数（可超过 int 范围）
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--tasks") == 0 && i + 1 < argc) {
+            task_path = argv[++i];
+        } else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc &&
+                   atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= TASK_MAX_HORIZON) {
+            horizon = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            num_cpus = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--arrival") == 0 && i + 1 < argc && parseArrivalSpec(argv[i + 1], &spec)) {
+            use_spec = 1;
+            i++;
+        } else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc && parseBurstSpec(argv[i + 1], &spec)) {
+            use_spec = 1;
+            i++;
+        } else if (strcmp(argv[i], "--gen-trace") == 0 && i + 1 < argc) {
+            gen_trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--time-slice") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            options.time_slice = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0) {
+            options.switch_cost = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tune-slice") == 0) {
+            tune_slice = 1;
+        } else if (strcmp(argv[i], "--bench-dispatch") == 0) {
+            bench_dispatch = 1;
+        } else if (strcmp(argv[i], "--bench-layout") == 0) {
+            bench_layout = 1;
+        } else if (strcmp(argv[i], "--affinity") == 0) {
+            affinity = 1;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep_seeds = 1000;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                sweep_seeds = atoi(argv[++i]);
+            }
+        } else if (argv[i][0] != '-' && atoll(argv[i]) > 0) {
+            gen_count = atoll(argv[i]);
+            num_processes = gen_count > INT_MAX ? INT_MAX : (int)gen_count;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench_dispatch) {
+        runDispatchBenchmark(seed);
+        return 0;
+    }
+
+    if (bench_layout) {
+        runLayoutBenchmark(seed);
+        return 0;
+    }
+
+    if (gen_trace_path != NULL) {
+        if (gen_count == 0) {
+            gen_count = num_processes;
+        }
+        double start = wallSeconds();
+        if (!generateTraceFile(gen_trace_path, gen_count, &spec, seed, num_threads)) {
+            return 1;
+        }
+        double elapsed = wallSeconds() - start;
+        printf("随机种子: %llu\n已生成 %lld 个进程到 %s，用时 %.3f 秒（每分钟 %.3g 个）\n",
+               seed, gen_count, gen_trace_path, elapsed, elapsed > 0 ? gen_count * 60.0 / elapsed : 0.0);
+        return 0;
+    }
+
+    if (sweep_seeds > 0) {
+        runSweep(sweep_seeds, num_threads);
+        return 0;
+    }
+
+    if (task_path != NULL || trace_path != NULL) {
+        TaskSet task_set;
+        Workload workload = {NULL, 0, trace_path, NULL};
+        if (task_path != NULL) {
+            if (!loadTaskSet(&task_set, task_path, horizon)) {
+                return 1;
+            }
+            printTaskSetAnalysis(&task_set);
+            workload.task_set = &task_set;
+        }
+        if (tune_slice) {
+            runSliceTuning(&workload, options.switch_cost, num_threads);
+        } else if (num_cpus > 0) {
+            runSmpAllAlgorithms(&workload, &options, num_cpus, num_threads);
+        } else {
+            runAllAlgorithms(&workload, &options); // 轨迹回放和周期任务集只输出统计结果
+        }
+        if (task_path != NULL) {
+            freeTaskSet(&task_set);
+        }
+        return 0;
+    }
+
+    PCB *processes = (PCB *)malloc(sizeof(PCB) * num_processes); // 定义进程数组
+    if (processes == NULL) {
+        perror("Failed to allocate processes");
+        return 1;
+    }
+
+    // 生成一份进程数据，三种算法各自复制后运行，确保使用相同初始数据
+    printf("随机种子: %llu\n", seed);
+    if (use_spec) {
+        double start = wallSeconds();
+        generateWorkload(processes, num_processes, &spec, seed, num_threads);
+        printf("按指定分布生成 %d 个进程，用时 %.3f 秒\n", num_processes, wallSeconds() - start);
+    } else {
+        initializeProcesses(processes, num_processes, seed);
+    }
+    // 进程数较多时只输出平均周转时间
+    options.verbosity = num_processes > MAX_PROCESSES ? VERBOSITY_RESULT : VERBOSITY_STATUS;
+    Workload workload = {processes, num_processes, NULL, NULL};
+    if (tune_slice) {
+        runSliceTuning(&workload, options.switch_cost, num_threads);
+    } else if (num_cpus > 0) {
+        for (int i = 0; affinity && i < num_processes; i++) {
+            processes[i].affinity = i % num_cpus; // 按序号轮流指定 CPU
+        }
+        runSmpAllAlgorithms(&workload, &options, num_cpus, num_threads);
+    } else {
+        runAllAlgorithms(&workload, &options);
+    }
 
+    free(processes);
     return 0; // 程序正常结束
 }
\ No newline at end of file
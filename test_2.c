@@ -1,7 +1,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdint.h> // uint64_t，位并行安全性检查的位图
 #include <time.h>
+#include <pthread.h> // 线程库，线程安全的银行家对象及其压力测试
+#include <stdatomic.h> // 压力测试的停止标志
+#ifdef _WIN32
+#include <windows.h> // QueryPerformanceCounter()，压力测试计时
+#include <malloc.h> // _aligned_malloc()，MSVC 和 MinGW 没有 aligned_alloc
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h> // AVX2 指令，用于资源向量运算
+#elif defined(__SSE2__)
+#include <emmintrin.h> // SSE2 指令，用于资源向量运算
+#endif
 
 // For sleep on Windows/Linux (optional, for observation)
 // #ifdef _WIN32
@@ -10,14 +24,29 @@
 // #include <unistd.h>
 // #endif
 
-#define NUM_RESOURCES 3 // 资源种类 A, B, C
-#define NUM_PROCESSES 5 // 进程数量
+#define DEFAULT_RESOURCES 3 // 默认资源种类 A, B, C
+#define DEFAULT_PROCESSES 5 // 默认进程数量
+#define PCB_TABLE_LIMIT 20  // 进程数超过此值时不再逐个打印 PCB
+#define VECTOR_LANES 8      // 资源向量按 8 个 int (32 字节) 补齐并对齐，向量指令无需处理尾部
+
+// 输出详细程度
+#define VERBOSITY_SILENT 0 // 不输出（基准测试、只记录事件轨迹的吞吐量测试）
+#define VERBOSITY_RESULT 1 // 只输出初始状态和结束时的统计
+#define VERBOSITY_EVENT 2  // 输出每次请求、分配、阻塞、唤醒和完成
+#define VERBOSITY_STATUS 3 // 每轮调度后还输出系统状态和 PCB 表
+
+// 资源种类数和进程数，由命令行参数指定
+int num_resources = DEFAULT_RESOURCES;
+int num_processes = DEFAULT_PROCESSES;
+int row_stride = VECTOR_LANES; // 资源向量的存储长度：num_resources 向上取整到 VECTOR_LANES 的倍数，补齐部分恒为 0
 
-// 资源名称
-char resource_names[NUM_RESOURCES] = {'A', 'B', 'C'};
+// 各类资源的基准总量，资源种类更多时循环使用；进程更多时按进程数成比例放大
+int base_totals[DEFAULT_RESOURCES] = {10, 15, 12};
+int resource_percent = 100; // 资源总量占上述默认总量的百分比，调低可以制造激烈的资源争用
+bool initial_allocation = true; // 为 false 时所有进程从零分配开始，初始状态必然安全
 
-// 系统可用资源
-int available[NUM_RESOURCES] = {10, 15, 12};
+// 系统可用资源 (row_stride)
+int *available = NULL;
 
 // 进程状态枚举
 typedef enum {
@@ -28,228 +57,1749 @@ typedef enum {
 } ProcessState;
 
 // 进程控制块 (PCB)
+// max、allocation、need 指向各矩阵中属于本进程的一行
 typedef struct {
     int pid;                            // 进程ID
-    int max[NUM_RESOURCES];             // 最大需求
-    int allocation[NUM_RESOURCES];      // 已分配资源
-    int need[NUM_RESOURCES];            // 还需要资源 (Max - Allocation)
+    int *max;                           // 最大需求
+    int *allocation;                    // 已分配资源
+    int *need;                          // 还需要资源 (Max - Allocation)
+    int *pending;                       // 阻塞时未被满足的请求，唤醒后原样重试
     ProcessState state;                 // 进程状态
+    unsigned int rng;                   // 本进程的随机请求序列，两种模式下相同
+    int rollbacks;                      // 死锁恢复时被回滚的次数
+    long long blocked_at;               // 本次阻塞的序号，越小阻塞得越早，唤醒时先重试
 } PCB;
 
-PCB processes[NUM_PROCESSES];
+// Max、Allocation、Need 矩阵：num_processes 行 row_stride 列，按行连续存放，每行 32 字节对齐
+int *max_matrix = NULL;
+int *allocation_matrix = NULL;
+int *need_matrix = NULL;
+int *pending_matrix = NULL; // 各进程阻塞时的请求
+
+PCB *processes = NULL;
 PCB *running_process = NULL; // 当前运行进程
 
 // 队列
-PCB *ready_queue[NUM_PROCESSES];
+PCB **ready_queue = NULL;
 int ready_front = -1, ready_rear = -1;
 
-PCB *block_queue[NUM_PROCESSES];
-int block_front = -1, block_rear = -1;
+// 阻塞队列：按阻塞先后相连的双向链表（进程号），唤醒或回滚时 O(1) 摘下，其余进程保持原有顺序
+int *block_prev = NULL, *block_next = NULL; // -1 表示没有前驱/后继
+int block_head = -1, block_tail = -1;
+
+PCB **finish_queue = NULL; // 完成队列，仅用作记录
+int finish_count = 0;      // 完成进程计数
+
+// 按资源划分的等待堆：阻塞进程放在其请求第一个超过 Available 的资源 j 的最小堆 wait_heap[j] 中，
+// 按 Pending[j] 排序；请求不超过 Available 但会导致不安全的进程放在 wait_heap[num_resources] 中（不排序）。
+// 释放资源 j 后只从堆顶取出 Pending[j] 之和不超过 Available[j] 的进程，其余进程不被访问；
+// 不安全集合中的进程每次释放都要重试，因为释放可能使它们变得安全。
+// 每个进程至多在一个堆中，各堆按需增长，总大小不超过进程数
+int **wait_heap = NULL;    // num_resources + 1 个堆，元素为进程号
+int *wait_size = NULL;     // 各堆的元素个数
+int *wait_capacity = NULL; // 各堆已分配的容量
+int *wait_list = NULL;     // 各进程所在的堆，-1 表示不在等待
+int *wait_pos = NULL;      // 各进程在堆中的位置
+int *released_work = NULL; // 正在唤醒等待者的释放量（释放者的 Allocation 已清零）
+long long block_serial = 0; // 已发生的阻塞次数，用作 blocked_at
+long long wake_checks = 0; // 唤醒时重新进行安全性检查的次数
+
+// 缓存的安全序列：最近一次安全性检查找到的进程顺序。
+// 之后的请求先沿此序列验证一遍 (O(n·m))，仍然可行就不必重新搜索。
+// 进程只会从未完成变为完成，已完成进程不占用资源，所以序列始终覆盖所有未完成进程。
+int *cached_sequence = NULL;
+int cached_length = 0;
+bool cache_valid = false;
+
+// 按需求排序的索引 (Habermann)：对每种资源 j，need_order[j*n .. j*n+n-1] 为按 (Need[j], 进程号) 升序排列的进程，
+// need_sorted 为对应的 Need 值（扫描时顺序读取），need_rank[j*n + i] 为进程 i 在其中的位置。
+// Need 改变时只把该进程在各列中挪到新位置，不重新排序。
+int *need_order = NULL;
+int *need_sorted = NULL;
+int *need_rank = NULL;
+
+// 安全性检查的工作区，避免每次检查都分配内存
+int *safety_work = NULL;      // Work 向量
+int *safety_cursor = NULL;    // 每种资源的排序索引中已满足的前缀长度
+int *safety_satisfied = NULL; // 每个进程已满足的资源种类数
+int *safety_stack = NULL;     // 全部资源都已满足、等待加入安全序列的进程
+int *safety_sequence = NULL;  // 本次检查找到的序列，安全时才写入缓存
+bool *safety_finish = NULL;   // 逐轮扫描算法的 Finish 向量
+// 位并行安全性检查的工作区：进程按 64 个一组，每组连续存放 num_resources 个字，
+// 组 w 的第 j 个字的第 b 位表示进程 w*64+b 的 Need[j] 不超过 Work[j]
+uint64_t *safety_bits = NULL;
+uint64_t *safety_done = NULL; // 每组中已完成或已加入序列的进程
+int *safety_dirty = NULL;     // 有新置位、需要重新求候选的组（栈）
+bool *safety_queued = NULL;   // 组是否已在 safety_dirty 中
+int *batch_ids = NULL;        // 批量准入的候选进程
+bool *batch_granted = NULL;   // 批量准入中各候选是否被批准
+bool *batch_best = NULL;      // 批量准入中回滚搜索选出的批准集合，与逐个检查比较时暂存
+int *batch_rank = NULL;       // 批量准入回滚时进程原来在各排序索引中的位置
+long long *batch_total = NULL; // 批量准入中各候选请求的总量，用于选择回滚的进程
+
+// 资源分配模式：避免模式每次分配前做安全性检查；检测模式只要 Available 够就分配，
+// 每隔 detect_interval 轮或所有进程都阻塞时运行死锁检测算法，回滚死锁进程来恢复
+typedef enum {
+    AVOIDANCE, // 死锁避免（银行家算法）
+    DETECTION  // 死锁检测与恢复
+} BankerMode;
+
+BankerMode banker_mode = AVOIDANCE;
+int detect_interval = 10; // 检测模式下定期检测的间隔轮数，0 表示只在停滞时检测
+int block_count = 0;      // 阻塞队列中的进程数
+int verbosity = VERBOSITY_STATUS;
+
+// 模拟过程的统计，用于比较两种模式
+typedef struct {
+    int rounds;               // 调度轮次
+    long long requests;       // 合法的资源请求数
+    long long grants;         // 批准的请求数（含唤醒后批准的）
+    long long blocks;         // 进入阻塞的次数
+    long long blocked_rounds; // 阻塞时间：每轮阻塞进程数之和（进程·轮）
+    long long safety_checks;  // 请求时的安全性检查次数（唤醒时的另计 wake_checks）
+    long long detections;     // 死锁检测次数
+    long long deadlocks;      // 检测到死锁的次数
+    long long rollbacks;      // 回滚的进程数
+    long long wasted_units;   // 回滚时收回的资源总量（需要重新申请的资源）
+} SimStats;
+
+SimStats stats;
 
-PCB *finish_queue[NUM_PROCESSES]; // 完成队列，仅用作记录
-int finish_count = 0;             // 完成进程计数
+// --- 内存分配 ---
+
+void* checked_malloc(size_t size) {
+    void *p = malloc(size);
+    if (p == NULL) {
+        perror("Failed to allocate memory");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// 分配 size 字节、32 字节对齐并清零的内存，必须用 free_vectors 释放
+int* checked_aligned_alloc(size_t size) {
+#ifdef _WIN32
+    int *p = (int *)_aligned_malloc(size, sizeof(int) * VECTOR_LANES);
+#else
+    int *p = (int *)aligned_alloc(sizeof(int) * VECTOR_LANES, size);
+#endif
+    if (p == NULL) {
+        perror("Failed to allocate memory");
+        exit(EXIT_FAILURE);
+    }
+    memset(p, 0, size);
+    return p;
+}
+
+// 释放 alloc_vectors / banker_vectors 分配的资源向量
+void free_vectors(int *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// 分配 count 个资源向量（每个 row_stride 个 int），32 字节对齐并清零
+int* alloc_vectors(size_t count) {
+    return checked_aligned_alloc(sizeof(int) * count * row_stride);
+}
+
+// 按当前的进程数和资源种类数分配所有矩阵、队列和工作区
+void alloc_banker() {
+    size_t n = num_processes, m = num_resources;
+    row_stride = (num_resources + VECTOR_LANES - 1) / VECTOR_LANES * VECTOR_LANES;
+    available = alloc_vectors(1);
+    max_matrix = alloc_vectors(n);
+    allocation_matrix = alloc_vectors(n);
+    need_matrix = alloc_vectors(n);
+    pending_matrix = alloc_vectors(n);
+    processes = (PCB *)checked_malloc(sizeof(PCB) * n);
+    for (size_t i = 0; i < n; i++) {
+        processes[i].max = max_matrix + i * row_stride;
+        processes[i].allocation = allocation_matrix + i * row_stride;
+        processes[i].need = need_matrix + i * row_stride;
+        processes[i].pending = pending_matrix + i * row_stride;
+    }
+    ready_queue = (PCB **)checked_malloc(sizeof(PCB *) * n);
+    block_prev = (int *)checked_malloc(sizeof(int) * n);
+    block_next = (int *)checked_malloc(sizeof(int) * n);
+    finish_queue = (PCB **)checked_malloc(sizeof(PCB *) * n);
+    wait_heap = (int **)checked_malloc(sizeof(int *) * (m + 1));
+    wait_size = (int *)checked_malloc(sizeof(int) * (m + 1));
+    wait_capacity = (int *)checked_malloc(sizeof(int) * (m + 1));
+    for (size_t j = 0; j <= m; j++) {
+        wait_heap[j] = NULL;
+        wait_size[j] = wait_capacity[j] = 0;
+    }
+    released_work = alloc_vectors(1);
+    wait_list = (int *)checked_malloc(sizeof(int) * n);
+    wait_pos = (int *)checked_malloc(sizeof(int) * n);
+    for (size_t i = 0; i < n; i++) {
+        wait_list[i] = -1;
+    }
+    cached_sequence = (int *)checked_malloc(sizeof(int) * n);
+    need_order = (int *)checked_malloc(sizeof(int) * n * m);
+    need_sorted = (int *)checked_malloc(sizeof(int) * n * m);
+    need_rank = (int *)checked_malloc(sizeof(int) * n * m);
+    safety_work = alloc_vectors(1);
+    safety_cursor = (int *)checked_malloc(sizeof(int) * m);
+    safety_satisfied = (int *)checked_malloc(sizeof(int) * n);
+    safety_stack = (int *)checked_malloc(sizeof(int) * n);
+    safety_sequence = (int *)checked_malloc(sizeof(int) * n);
+    safety_finish = (bool *)checked_malloc(sizeof(bool) * n);
+    size_t words = (n + 63) / 64;
+    safety_bits = (uint64_t *)checked_malloc(sizeof(uint64_t) * words * m);
+    safety_done = (uint64_t *)checked_malloc(sizeof(uint64_t) * words);
+    safety_dirty = (int *)checked_malloc(sizeof(int) * words);
+    safety_queued = (bool *)checked_malloc(sizeof(bool) * words);
+    batch_ids = (int *)checked_malloc(sizeof(int) * n);
+    batch_granted = (bool *)checked_malloc(sizeof(bool) * n);
+    batch_best = (bool *)checked_malloc(sizeof(bool) * n);
+    batch_rank = (int *)checked_malloc(sizeof(int) * m);
+    batch_total = (long long *)checked_malloc(sizeof(long long) * n);
+    // 重置队列和计数，基准测试会多次分配
+    ready_front = ready_rear = -1;
+    block_head = block_tail = -1;
+    finish_count = 0;
+    block_count = 0;
+    block_serial = 0;
+    running_process = NULL;
+    wake_checks = 0;
+    cache_valid = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void free_banker() {
+    free_vectors(available);
+    free_vectors(max_matrix);
+    free_vectors(allocation_matrix);
+    free_vectors(need_matrix);
+    free_vectors(pending_matrix);
+    free(processes);
+    free(ready_queue);
+    free(block_prev);
+    free(block_next);
+    free(finish_queue);
+    for (int j = 0; j <= num_resources; j++) {
+        free(wait_heap[j]);
+    }
+    free(wait_heap);
+    free(wait_size);
+    free(wait_capacity);
+    free(wait_list);
+    free(wait_pos);
+    free_vectors(released_work);
+    free(cached_sequence);
+    free(need_order);
+    free(need_sorted);
+    free(need_rank);
+    free_vectors(safety_work);
+    free(safety_cursor);
+    free(safety_satisfied);
+    free(safety_stack);
+    free(safety_sequence);
+    free(safety_finish);
+    free(safety_bits);
+    free(safety_done);
+    free(safety_dirty);
+    free(safety_queued);
+    free(batch_ids);
+    free(batch_granted);
+    free(batch_best);
+    free(batch_rank);
+    free(batch_total);
+}
 
 // --- 队列操作 ---
+// 队列为长度 num_processes 的环形数组，每个进程同一时刻至多在一个队列中，不会溢出
 // 将进程加入队列
 void enqueue(PCB *queue[], int *front, int *rear, PCB *p) {
-    if (*rear == NUM_PROCESSES - 1) {
-        // printf("Queue is full.\n"); // 队列已满，理论上不会发生（进程数固定）
-        return;
-    }
     if (*front == -1) { // 队列为空时，设置front
         *front = 0;
+        *rear = 0;
+    } else {
+        if ((*rear + 1) % num_processes == *front) {
+            // printf("Queue is full.\n"); // 队列已满，理论上不会发生（进程数固定）
+            return;
+        }
+        *rear = (*rear + 1) % num_processes;
     }
-    (*rear)++;
     queue[*rear] = p;
 }
 
 // 从队列中取出进程
 PCB* dequeue(PCB *queue[], int *front, int *rear) {
-    if (*front == -1 || *front > *rear) { // 队列为空
+    if (*front == -1) { // 队列为空
         return NULL;
     }
     PCB *p = queue[*front];
-    (*front)++;
-    if (*front > *rear) { // 如果取出后队列为空，重置front和rear
+    if (*front == *rear) { // 如果取出后队列为空，重置front和rear
         *front = -1;
         *rear = -1;
+    } else {
+        *front = (*front + 1) % num_processes;
     }
     return p;
 }
 
 // 检查队列是否为空
 bool is_queue_empty(int front, int rear) {
-    return front == -1 || front > rear;
+    (void)rear;
+    return front == -1;
+}
+
+// 按顺序打印队列中的进程
+void print_queue(PCB *queue[], int front, int rear) {
+    if (is_queue_empty(front, rear)) {
+        printf("空\n");
+        return;
+    }
+    for (int i = front; ; i = (i + 1) % num_processes) {
+        printf("P%d ", queue[i]->pid);
+        if (i == rear) {
+            break;
+        }
+    }
+    printf("\n");
+}
+
+// --- 向量输出 ---
+
+// 打印资源向量的各分量，如 1,2,3
+void print_values(const int v[]) {
+    for (int j = 0; j < num_resources; j++) {
+        printf(j ? ",%d" : "%d", v[j]);
+    }
+}
+
+// 打印资源向量，如 (1,2,3)
+void print_vector(const int v[]) {
+    printf("(");
+    print_values(v);
+    printf(")");
+}
+
+// 打印资源名称列表，如 (A,B,C)；超过 26 种时其余资源记为 R26、R27 ...
+void print_resource_names() {
+    printf("(");
+    for (int j = 0; j < num_resources; j++) {
+        if (j < 26) {
+            printf(j ? ",%c" : "%c", 'A' + j);
+        } else {
+            printf(",R%d", j);
+        }
+    }
+    printf(")");
+}
+
+// --- 事件记录 ---
+// 模拟过程中的事件既可以按 verbosity 输出为文字，也可以写入事件轨迹文件，事后据此重放整个过程。
+// 轨迹由初始化时每个进程的 declare (Max) 和 grant (初始 Allocation) 开始，之后为
+// request、grant、block、wake（唤醒并分配 pending 请求）、finish 和 rollback（死锁恢复）。
+// finish 和 rollback 的向量为事件后的 Available，其余为请求或分配的资源向量。两种格式：
+//   NDJSON：首行 {"event":"header","processes":n,"resources":m,"seed":s,"mode":"avoidance","total":[...]}，
+//           之后每行一个事件，如 {"round":3,"event":"block","pid":1,"detail":1,"vector":[0,2,1]}
+//   二进制：8 字节文件头 "BNKTRC01"，随后 int32 进程数、资源种类数、模式、种子和 m 个资源总量；
+//           每条记录为 int32 事件类型、轮次、进程号、附加值和 m 个 int32 的向量，均为小端
+// 附加值：block 为阻塞原因（0 资源不足，1 会导致不安全），rollback 为收回的资源数，其余为 0。
+// 记录先写入内存缓冲区，满了再整块写出，静默运行时记录事件的开销只有格式化本身
+#define TRACE_MAGIC "BNKTRC01"
+#define TRACE_MAGIC_LEN 8
+#define TRACE_BUFFER_SIZE (1 << 20) // 写缓冲区大小
+#define TRACE_RECORD_MAX 64         // 一条记录除向量外最多占用的字节数
+
+typedef enum {
+    EVENT_DECLARE,
+    EVENT_REQUEST,
+    EVENT_GRANT,
+    EVENT_BLOCK,
+    EVENT_WAKE,
+    EVENT_FINISH,
+    EVENT_ROLLBACK
+} EventType;
+
+const char *event_names[] = {"declare", "request", "grant", "block", "wake", "finish", "rollback"};
+
+typedef struct {
+    FILE *fp;
+    bool binary;  // true 为二进制格式，false 为 NDJSON
+    char *buffer;
+    size_t used;
+    bool failed;  // 写入出错后不再写出
+} TraceWriter;
+
+TraceWriter trace = {NULL, false, NULL, 0, false};
+
+// 打开事件轨迹文件，失败返回 false
+bool trace_open(const char *path, bool binary) {
+    trace.fp = fopen(path, binary ? "wb" : "w");
+    if (trace.fp == NULL) {
+        perror(path);
+        return false;
+    }
+    trace.binary = binary;
+    trace.buffer = (char *)checked_malloc(TRACE_BUFFER_SIZE);
+    trace.used = 0;
+    trace.failed = false;
+    return true;
+}
+
+void trace_flush() {
+    if (trace.used > 0 && !trace.failed && fwrite(trace.buffer, 1, trace.used, trace.fp) != trace.used) {
+        perror("事件轨迹写入失败");
+        trace.failed = true;
+    }
+    trace.used = 0;
+}
+
+void trace_close() {
+    if (trace.fp == NULL) {
+        return;
+    }
+    trace_flush();
+    if (fclose(trace.fp) != 0 && !trace.failed) {
+        perror("事件轨迹写入失败");
+    }
+    free(trace.buffer);
+    trace.fp = NULL;
+    trace.buffer = NULL;
+}
+
+// 保证缓冲区还能放下 bytes 字节，返回写入位置
+char* trace_reserve(size_t bytes) {
+    if (trace.used + bytes > TRACE_BUFFER_SIZE) {
+        trace_flush();
+    }
+    return trace.buffer + trace.used;
+}
+
+void trace_put_int32(int value) {
+    unsigned int v = (unsigned int)value;
+    unsigned char *out = (unsigned char *)trace.buffer + trace.used;
+    out[0] = (unsigned char)v;
+    out[1] = (unsigned char)(v >> 8);
+    out[2] = (unsigned char)(v >> 16);
+    out[3] = (unsigned char)(v >> 24);
+    trace.used += 4;
+}
+
+// 十进制写出整数，比 snprintf 快得多
+void trace_put_decimal(long long value) {
+    char digits[24];
+    int count = 0;
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[count++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0) {
+        trace.buffer[trace.used++] = '-';
+    }
+    while (count > 0) {
+        trace.buffer[trace.used++] = digits[--count];
+    }
+}
+
+void trace_put_text(const char *text) {
+    size_t length = strlen(text);
+    memcpy(trace.buffer + trace.used, text, length);
+    trace.used += length;
+}
+
+// 写入资源向量：二进制为 m 个 int32，NDJSON 为 [a,b,...]
+void trace_put_vector(const int v[]) {
+    if (trace.binary) {
+        for (int j = 0; j < num_resources; j++) {
+            trace_put_int32(v[j]);
+        }
+        return;
+    }
+    trace.buffer[trace.used++] = '[';
+    for (int j = 0; j < num_resources; j++) {
+        if (j > 0) {
+            trace.buffer[trace.used++] = ',';
+        }
+        trace_put_decimal(v[j]);
+    }
+    trace.buffer[trace.used++] = ']';
+}
+
+// 一个资源向量最多占用的字节数（NDJSON 每个分量最多 11 个字符加逗号）
+size_t trace_vector_bytes() {
+    return (size_t)num_resources * 12 + 2;
+}
+
+// 写入文件头：进程数、资源种类数、随机种子、模式和各资源总量
+void trace_header(unsigned int seed, const int total[]) {
+    if (trace.fp == NULL) {
+        return;
+    }
+    trace_reserve(TRACE_MAGIC_LEN + 2 * TRACE_RECORD_MAX + trace_vector_bytes());
+    if (trace.binary) {
+        memcpy(trace.buffer + trace.used, TRACE_MAGIC, TRACE_MAGIC_LEN);
+        trace.used += TRACE_MAGIC_LEN;
+        trace_put_int32(num_processes);
+        trace_put_int32(num_resources);
+        trace_put_int32(banker_mode);
+        trace_put_int32((int)seed);
+    } else {
+        trace_put_text("{\"event\":\"header\",\"processes\":");
+        trace_put_decimal(num_processes);
+        trace_put_text(",\"resources\":");
+        trace_put_decimal(num_resources);
+        trace_put_text(",\"seed\":");
+        trace_put_decimal(seed);
+        trace_put_text(banker_mode == DETECTION ? ",\"mode\":\"detection\",\"total\":" : ",\"mode\":\"avoidance\",\"total\":");
+    }
+    trace_put_vector(total);
+    if (!trace.binary) {
+        trace_put_text("}\n");
+    }
+}
+
+// 把一个事件写入轨迹文件
+void trace_event(EventType type, int pid, const int v[], long long detail) {
+    if (trace.fp == NULL) {
+        return;
+    }
+    trace_reserve(TRACE_RECORD_MAX + trace_vector_bytes());
+    if (trace.binary) {
+        trace_put_int32(type);
+        trace_put_int32(stats.rounds);
+        trace_put_int32(pid);
+        trace_put_int32((int)detail);
+    } else {
+        trace_put_text("{\"round\":");
+        trace_put_decimal(stats.rounds);
+        trace_put_text(",\"event\":\"");
+        trace_put_text(event_names[type]);
+        trace_put_text("\",\"pid\":");
+        trace_put_decimal(pid);
+        if (detail != 0) {
+            trace_put_text(",\"detail\":");
+            trace_put_decimal(detail);
+        }
+        trace_put_text(",\"vector\":");
+    }
+    trace_put_vector(v);
+    if (!trace.binary) {
+        trace_put_text("}\n");
+    }
+}
+
+// 记录事件：写入轨迹文件，verbosity 足够时输出文字说明。算法中只调用此函数，不直接输出
+void log_event(EventType type, const PCB *p, const int v[], long long detail) {
+    trace_event(type, p->pid, v, detail);
+    if (verbosity < VERBOSITY_EVENT) {
+        return;
+    }
+    switch (type) {
+    case EVENT_DECLARE:
+        printf("P%d 声明最大需求 ", p->pid);
+        print_vector(v);
+        printf("\n");
+        break;
+    case EVENT_REQUEST:
+        printf("P%d 随机申请资源...\n", p->pid);
+        printf("P%d 请求: ", p->pid);
+        print_vector(v);
+        printf("\n");
+        break;
+    case EVENT_GRANT:
+    case EVENT_WAKE:
+        printf("P%d 请求资源 ", p->pid);
+        print_vector(v);
+        printf(" 成功分配！\n");
+        if (type == EVENT_WAKE) {
+            printf("P%d 从阻塞队列唤醒，并成功分配资源，进入就绪队列。\n", p->pid);
+        }
+        break;
+    case EVENT_BLOCK:
+        printf("P%d 请求资源 ", p->pid);
+        print_vector(v);
+        if (detail == 0) {
+            printf(" 暂时无法满足 (Available: ");
+            print_values(available);
+            printf(")，进入阻塞队列。\n");
+        } else {
+            printf(" 会导致系统进入不安全状态，拒绝分配。进入阻塞队列。\n");
+        }
+        break;
+    case EVENT_FINISH:
+        printf("P%d 完成并释放所有资源。当前Available: ", p->pid);
+        print_vector(v);
+        printf("\n");
+        break;
+    case EVENT_ROLLBACK:
+        printf("回滚 P%d：收回 %lld 个资源，进程重新开始。当前Available: ", p->pid, detail);
+        print_vector(v);
+        printf("\n");
+        break;
+    }
 }
 
 // --- 银行家算法相关函数 ---
 
-// 检查向量a是否小于等于向量b (a <= b)
-bool less_equal(int a[], int b[]) {
-    for (int i = 0; i < NUM_RESOURCES; i++) {
+// --- 资源向量运算 ---
+// 向量都按 VECTOR_LANES 补齐且 32 字节对齐，length 为存储长度。编译时启用 AVX2 (-mavx2) 则每次处理 8 类资源，
+// 否则在 x86-64 上用 SSE2 每次处理 4 类，其他平台退回逐个比较的标量循环
+
+// 检查长度为 length 的向量a是否小于等于向量b (a <= b)
+bool vector_less_equal(const int a[], const int b[], int length) {
+#if defined(__AVX2__)
+    for (int i = 0; i < length; i += 8) {
+        __m256i greater = _mm256_cmpgt_epi32(_mm256_load_si256((const __m256i *)(a + i)),
+                                             _mm256_load_si256((const __m256i *)(b + i)));
+        if (!_mm256_testz_si256(greater, greater)) {
+            return false;
+        }
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < length; i += 4) {
+        __m128i greater = _mm_cmpgt_epi32(_mm_load_si128((const __m128i *)(a + i)),
+                                          _mm_load_si128((const __m128i *)(b + i)));
+        if (_mm_movemask_epi8(greater)) {
+            return false;
+        }
+    }
+#else
+    for (int i = 0; i < length; i++) {
         if (a[i] > b[i]) {
             return false;
         }
     }
+#endif
+    return true;
+}
+
+// dst += src
+void vector_add(int dst[], const int src[], int length) {
+#if defined(__AVX2__)
+    for (int i = 0; i < length; i += 8) {
+        __m256i sum = _mm256_add_epi32(_mm256_load_si256((const __m256i *)(dst + i)),
+                                       _mm256_load_si256((const __m256i *)(src + i)));
+        _mm256_store_si256((__m256i *)(dst + i), sum);
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < length; i += 4) {
+        __m128i sum = _mm_add_epi32(_mm_load_si128((const __m128i *)(dst + i)),
+                                    _mm_load_si128((const __m128i *)(src + i)));
+        _mm_store_si128((__m128i *)(dst + i), sum);
+    }
+#else
+    for (int i = 0; i < length; i++) {
+        dst[i] += src[i];
+    }
+#endif
+}
+
+// dst -= src
+void vector_sub(int dst[], const int src[], int length) {
+#if defined(__AVX2__)
+    for (int i = 0; i < length; i += 8) {
+        __m256i diff = _mm256_sub_epi32(_mm256_load_si256((const __m256i *)(dst + i)),
+                                        _mm256_load_si256((const __m256i *)(src + i)));
+        _mm256_store_si256((__m256i *)(dst + i), diff);
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < length; i += 4) {
+        __m128i diff = _mm_sub_epi32(_mm_load_si128((const __m128i *)(dst + i)),
+                                     _mm_load_si128((const __m128i *)(src + i)));
+        _mm_store_si128((__m128i *)(dst + i), diff);
+    }
+#else
+    for (int i = 0; i < length; i++) {
+        dst[i] -= src[i];
+    }
+#endif
+}
+
+// 检查向量a是否小于等于向量b (a <= b)
+bool less_equal(const int a[], const int b[]) {
+    return vector_less_equal(a, b, row_stride);
+}
+
+// dst += src，用于安全性检查中模拟进程完成后 Work 加上其已分配资源
+void add_vector(int dst[], const int src[]) {
+    vector_add(dst, src, row_stride);
+}
+
+// 按 request 在 Available 与进程之间转移资源：sign 为 1 时试分配
+// (Available -= Request, Allocation += Request, Need -= Request)，为 -1 时回滚
+void transfer_request(PCB *p, const int request[], int sign) {
+#if defined(__AVX2__)
+    __m256i signs = _mm256_set1_epi32(sign);
+    for (int i = 0; i < row_stride; i += 8) {
+        __m256i delta = _mm256_sign_epi32(_mm256_load_si256((const __m256i *)(request + i)), signs); // sign * Request
+        __m256i *avail = (__m256i *)(available + i);
+        __m256i *alloc = (__m256i *)(p->allocation + i);
+        __m256i *need = (__m256i *)(p->need + i);
+        _mm256_store_si256(avail, _mm256_sub_epi32(_mm256_load_si256(avail), delta));
+        _mm256_store_si256(alloc, _mm256_add_epi32(_mm256_load_si256(alloc), delta));
+        _mm256_store_si256(need, _mm256_sub_epi32(_mm256_load_si256(need), delta));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < row_stride; i += 4) {
+        __m128i delta = _mm_load_si128((const __m128i *)(request + i));
+        if (sign < 0) {
+            delta = _mm_sub_epi32(_mm_setzero_si128(), delta);
+        }
+        __m128i *avail = (__m128i *)(available + i);
+        __m128i *alloc = (__m128i *)(p->allocation + i);
+        __m128i *need = (__m128i *)(p->need + i);
+        _mm_store_si128(avail, _mm_sub_epi32(_mm_load_si128(avail), delta));
+        _mm_store_si128(alloc, _mm_add_epi32(_mm_load_si128(alloc), delta));
+        _mm_store_si128(need, _mm_sub_epi32(_mm_load_si128(need), delta));
+    }
+#else
+    for (int i = 0; i < num_resources; i++) {
+        available[i] -= sign * request[i];
+        p->allocation[i] += sign * request[i];
+        p->need[i] -= sign * request[i];
+    }
+#endif
+}
+
+// 进程 i 的 Need 改变后，把它在每种资源的排序索引中挪到新位置
+// 代价与它移过的进程数成正比，小请求只移动很短的距离
+void update_need_order(int i) {
+    int n = num_processes;
+    for (int j = 0; j < num_resources; j++) {
+        int *order = need_order + (size_t)j * n;
+        int *sorted = need_sorted + (size_t)j * n;
+        int *rank = need_rank + (size_t)j * n;
+        int value = processes[i].need[j];
+        int pos = rank[i];
+        // Need 减小，向前移动
+        while (pos > 0 && (sorted[pos - 1] > value || (sorted[pos - 1] == value && order[pos - 1] > i))) {
+            order[pos] = order[pos - 1];
+            sorted[pos] = sorted[pos - 1];
+            rank[order[pos]] = pos;
+            pos--;
+        }
+        // Need 增大，向后移动
+        while (pos < n - 1 && (sorted[pos + 1] < value || (sorted[pos + 1] == value && order[pos + 1] < i))) {
+            order[pos] = order[pos + 1];
+            sorted[pos] = sorted[pos + 1];
+            rank[order[pos]] = pos;
+            pos++;
+        }
+        order[pos] = i;
+        sorted[pos] = value;
+        rank[i] = pos;
+    }
+}
+
+int compare_key(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+// 初始化时为每种资源建立按需求排序的索引，O(m·n log n)
+// 排序键把 Need 放在高 32 位、进程号放在低 32 位，需求相同时按进程号排列
+void build_need_order() {
+    int n = num_processes;
+    unsigned long long *keys = (unsigned long long *)checked_malloc(sizeof(unsigned long long) * n);
+    for (int j = 0; j < num_resources; j++) {
+        for (int i = 0; i < n; i++) {
+            keys[i] = ((unsigned long long)processes[i].need[j] << 32) | (unsigned)i;
+        }
+        qsort(keys, n, sizeof(unsigned long long), compare_key);
+        for (int k = 0; k < n; k++) {
+            int i = (int)(keys[k] & 0xffffffffu);
+            need_order[(size_t)j * n + k] = i;
+            need_sorted[(size_t)j * n + k] = (int)(keys[k] >> 32);
+            need_rank[(size_t)j * n + i] = k;
+        }
+    }
+    free(keys);
+}
+
+// 打印安全序列
+void print_safe_sequence(int sequence[], int length) {
+    printf("安全序列: ");
+    for (int i = 0; i < length; i++) {
+        if (processes[sequence[i]].state != FINISH) { // 已完成的进程不再列出
+            printf("P%d ", sequence[i]);
+        }
+    }
+    printf("\n");
+}
+
+// 快速路径：沿缓存的安全序列验证当前状态，只需一遍 O(n·m)，不输出
+bool cached_sequence_holds(const int current_available[]) {
+    if (!cache_valid) {
+        return false;
+    }
+    int *work = safety_work;
+    for (int i = 0; i < num_resources; i++) {
+        work[i] = current_available[i];
+    }
+    for (int k = 0; k < cached_length; k++) {
+        PCB *p = &processes[cached_sequence[k]];
+        if (p->state == FINISH) { // 已完成的进程不占用资源
+            continue;
+        }
+        if (!less_equal(p->need, work)) {
+            return false; // 序列在此处断开，需要重新搜索
+        }
+        add_vector(work, p->allocation);
+    }
+    return true;
+}
+
+// 沿缓存的安全序列验证当前状态，成立时输出该序列
+bool cached_sequence_safe(const int current_available[]) {
+    if (!cached_sequence_holds(current_available)) {
+        return false;
+    }
+    if (verbosity >= VERBOSITY_EVENT) {
+        print_safe_sequence(cached_sequence, cached_length);
+    }
     return true;
 }
 
-// 安全性算法：检查当前系统是否处于安全状态
-bool is_safe(int current_available[NUM_RESOURCES]) {
-    int work[NUM_RESOURCES];
+// 第 j 种资源的 Work 增加后，把排序索引中新满足的进程计入；全部资源都满足的进程入栈
+void advance_cursor(int j, int *top) {
+    int n = num_processes;
+    const int *order = need_order + (size_t)j * n;
+    const int *sorted = need_sorted + (size_t)j * n;
+    int cursor = safety_cursor[j];
+    while (cursor < n && sorted[cursor] <= safety_work[j]) {
+        int i = order[cursor];
+        cursor++;
+        if (++safety_satisfied[i] == num_resources && processes[i].state != FINISH) {
+            safety_stack[(*top)++] = i;
+        }
+    }
+    safety_cursor[j] = cursor;
+}
+
+// 安全性算法 (Habermann)：每种资源沿排序索引维护一个游标，Work 增加时游标只向前推进，
+// 进程的全部资源都被游标越过时即可完成。每个 (进程, 资源) 至多被越过一次，
+// 加上维护排序索引，总代价 O(m·n log n)，而逐轮扫描为 O(m·n²)。这只是最坏情况的界：随机状态下逐轮扫描
+// 一两轮就能结束，顺序访问内存，反而快十几倍，所以 is_safe 和 admit_batch 都先做有界的逐轮扫描。
+// 找到安全序列时写入 sequence 并返回 true
+bool find_safe_sequence(const int current_available[], int sequence[], int *length) {
+    int unfinished = 0;
+    for (int i = 0; i < num_processes; i++) {
+        safety_satisfied[i] = 0;
+        unfinished += (processes[i].state != FINISH);
+    }
+    int top = 0, count = 0;
+    for (int j = 0; j < num_resources; j++) {
+        safety_work[j] = current_available[j];
+        safety_cursor[j] = 0;
+        advance_cursor(j, &top);
+    }
+    while (top > 0) {
+        int i = safety_stack[--top];
+        sequence[count++] = i;
+        const int *allocation = processes[i].allocation;
+        add_vector(safety_work, allocation); // 模拟进程完成并释放
+        for (int j = 0; j < num_resources; j++) {
+            if (allocation[j] > 0) {
+                advance_cursor(j, &top);
+            }
+        }
+    }
+    *length = count;
+    return count == unfinished;
+}
+
+// 最低的置位位的序号，x 不为 0
+int lowest_bit(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int b = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+// 第 j 种资源的 Work 增加后，沿排序索引把新满足的进程在位图中置位，所在的组入栈等待重新求候选
+void advance_bits(int j, int *dirty) {
+    int n = num_processes, m = num_resources;
+    const int *order = need_order + (size_t)j * n;
+    const int *sorted = need_sorted + (size_t)j * n;
+    int cursor = safety_cursor[j];
+    while (cursor < n && sorted[cursor] <= safety_work[j]) {
+        int i = order[cursor];
+        cursor++;
+        int w = i >> 6;
+        safety_bits[(size_t)w * m + j] |= 1ULL << (i & 63);
+        if (!safety_queued[w]) {
+            safety_queued[w] = true;
+            safety_dirty[(*dirty)++] = w;
+        }
+    }
+    safety_cursor[j] = cursor;
+}
+
+// 组 w 中全部资源都已满足且尚未加入序列的进程：m 个字按位与，一次判断 64 个进程
+uint64_t word_candidates(int w) {
+    const uint64_t *bits = safety_bits + (size_t)w * num_resources;
+    uint64_t candidates = ~safety_done[w];
+    for (int j = 0; j < num_resources && candidates != 0; j++) {
+        candidates &= bits[j];
+    }
+    return candidates;
+}
+
+// 位并行搜索的主体：safety_work 为当前 Work，finished[i] 为 true 的进程已经完成或已在 sequence 的
+// 前 count 项中。沿排序索引把各资源的游标从头推进到 Work，再从新置位的组中不断取出可以完成的进程
+bool continue_safe_sequence_bitset(const bool finished[], int sequence[], int count, int *length) {
+    int n = num_processes, m = num_resources;
+    int words = (n + 63) / 64;
+    memset(safety_bits, 0, sizeof(uint64_t) * words * m);
+    memset(safety_done, 0, sizeof(uint64_t) * words);
+    int target = 0; // 序列应有的长度：所有未处于 FINISH 状态的进程
+    for (int i = 0; i < n; i++) {
+        if (finished[i]) {
+            safety_done[i >> 6] |= 1ULL << (i & 63);
+        }
+        target += (processes[i].state != FINISH);
+    }
+    if (n % 64 != 0) {
+        safety_done[words - 1] |= ~0ULL << (n % 64); // 最后一组补齐的位不是进程
+    }
+    for (int w = 0; w < words; w++) {
+        safety_queued[w] = false;
+    }
+    int dirty = 0;
+    for (int j = 0; j < m; j++) {
+        safety_cursor[j] = 0;
+        advance_bits(j, &dirty);
+    }
+    while (dirty > 0 && count < target) {
+        int w = safety_dirty[--dirty];
+        uint64_t candidates;
+        // 处理本组时新置位的进程在重新求候选时取出，本组仍标记为在栈中，不必重复入栈
+        while ((candidates = word_candidates(w)) != 0) {
+            do {
+                int b = lowest_bit(candidates);
+                candidates &= candidates - 1;
+                int i = w * 64 + b;
+                safety_done[w] |= 1ULL << b;
+                sequence[count++] = i;
+                const int *allocation = processes[i].allocation;
+                add_vector(safety_work, allocation); // 模拟进程完成并释放
+                for (int j = 0; j < m; j++) {
+                    if (allocation[j] > 0) {
+                        advance_bits(j, &dirty);
+                    }
+                }
+            } while (candidates != 0);
+        }
+        safety_queued[w] = false;
+    }
+    *length = count;
+    return count == target;
+}
+
+// 位并行的安全性算法：与 Habermann 算法一样沿排序索引推进各资源的游标，
+// 但不为每个进程累计已满足的资源数，而是为每种资源维护"Need[j] <= Work[j]"的位图。
+// 只有新置位的组需要重新求候选：m 个字按位与后用 lowest_bit 逐个取出可以完成的进程。
+// 置位是对每种资源各自很小的位图（n/8 字节）的写，比对 n 个计数器的随机加一更容易命中缓存
+bool find_safe_sequence_bitset(const int current_available[], int sequence[], int *length) {
+    for (int i = 0; i < num_processes; i++) {
+        safety_finish[i] = (processes[i].state == FINISH); // 已完成的进程不占用资源，直接视为已完成
+    }
+    for (int j = 0; j < num_resources; j++) {
+        safety_work[j] = current_available[j];
+    }
+    return continue_safe_sequence_bitset(safety_finish, sequence, 0, length);
+}
+
+// 有界的逐轮扫描最多检查的进程次数，以本次的未完成进程数为单位
+#define SCAN_BUDGET_PASSES 4
+
+// 逐轮扫描：每轮遍历所有未完成进程。bounded 为 true 时，累计检查的进程次数超过未完成进程数的
+// SCAN_BUDGET_PASSES 倍仍未结束就放弃并置 *stalled，此时 safety_work 和 safety_finish 保存着
+// 已加入序列的前 *length 个进程完成后的状态，可以由位并行搜索接着找；否则扫描到结束，最坏 O(m·n²)
+bool scan_safe_sequence(const int current_available[], int sequence[], int *length, bool bounded, bool *stalled) {
+    *stalled = false;
+    int *work = safety_work;
     // 初始化工作向量Work为当前的Available
-    for (int i = 0; i < NUM_RESOURCES; i++) {
+    for (int i = 0; i < num_resources; i++) {
         work[i] = current_available[i];
     }
 
-    bool finish[NUM_PROCESSES] = {false}; // 记录进程是否已完成
-    int safe_sequence[NUM_PROCESSES];     // 记录安全序列
-    int count = 0;                        // 已找到的安全进程数量
+    bool *finish = safety_finish; // 记录进程是否已完成
+    int count = 0;                // 已找到的安全进程数量
+    int unfinished = 0;           // 需要检查的（未完成）进程数量
 
-    // 复制进程状态，确保不修改原始进程数据
-    // 在安全性检查中，只考虑未完成（非FINISH状态）的进程
-    PCB temp_processes[NUM_PROCESSES];
-    for(int i = 0; i < NUM_PROCESSES; i++) {
-        temp_processes[i] = processes[i];
+    // 已完成（FINISH状态）的进程不占用资源，直接视为已完成
+    for (int i = 0; i < num_processes; i++) {
+        finish[i] = (processes[i].state == FINISH);
+        unfinished += !finish[i];
     }
 
-    int loop_iterations = 0; // 防止无限循环，最多检查 NUM_PROCESSES * 2 次
-    while (count < NUM_PROCESSES && loop_iterations < NUM_PROCESSES * 2) {
+    long long checked = 0; // 累计检查的进程次数
+    while (count < unfinished) {
         bool found = false; // 标记是否找到可以执行的进程
-        for (int i = 0; i < NUM_PROCESSES; i++) {
+        checked += unfinished - count;
+        for (int i = 0; i < num_processes; i++) {
             // 如果进程i尚未完成安全性检查，且其Need <= Work
-            if (finish[i] == false && temp_processes[i].state != FINISH && less_equal(temp_processes[i].need, work)) {
+            if (finish[i] == false && less_equal(processes[i].need, work)) {
                 // 模拟分配资源并释放
-                for (int j = 0; j < NUM_RESOURCES; j++) {
-                    work[j] += temp_processes[i].allocation[j]; // 加上已分配资源（模拟进程完成并释放）
+                add_vector(work, processes[i].allocation); // 加上已分配资源（模拟进程完成并释放）
+                finish[i] = true;           // 标记为已完成
+                sequence[count++] = i;      // 加入安全序列
+                found = true;               // 找到一个进程
+            }
+        }
+        if (!found) { // 如果一轮遍历后没有找到任何可以满足的进程，则系统不安全
+            break;
+        }
+        if (bounded && count < unfinished && checked + (unfinished - count) > (long long)SCAN_BUDGET_PASSES * unfinished) {
+            *stalled = true; // 下一轮会超出预算，继续扫描可能退化为平方复杂度
+            break;
+        }
+    }
+    *length = count;
+    return count == unfinished;
+}
+
+// 逐轮扫描的安全性算法，O(m·n²)，用于对照
+bool find_safe_sequence_passes(const int current_available[], int sequence[], int *length) {
+    bool stalled;
+    return scan_safe_sequence(current_available, sequence, length, false, &stalled);
+}
+
+// 先逐轮扫描，超出预算时由位并行算法从扫描停下的地方接着找。随机状态下扫描几轮就能结束，
+// 顺序访问内存，比建立在排序索引上的搜索快数倍；扫描部分不超过 O(SCAN_BUDGET_PASSES·m·n)，
+// 链式等进展缓慢的状态只多付出几轮扫描的代价，已经找到的进程也不必重新处理
+bool find_safe_sequence_hybrid(const int current_available[], int sequence[], int *length) {
+    bool stalled;
+    bool safe = scan_safe_sequence(current_available, sequence, length, true, &stalled);
+    if (stalled) {
+        return continue_safe_sequence_bitset(safety_finish, sequence, *length, length);
+    }
+    return safe;
+}
+
+// 搜索安全序列，找到时存入缓存，不输出。
+// 先逐轮扫描，卡住时改用位并行算法；admit_batch 回滚时需要各进程已满足的资源数，用 admit_search 的计数方式
+bool search_safe_sequence(const int current_available[]) {
+    int count;
+    if (!find_safe_sequence_hybrid(current_available, safety_sequence, &count)) {
+        return false; // 没有找到安全序列，缓存的序列仍对应回滚后的状态
+    }
+    for (int i = 0; i < count; i++) {
+        cached_sequence[i] = safety_sequence[i];
+    }
+    cached_length = count;
+    cache_valid = true;
+    return true;
+}
+
+// 安全性检查：检查当前系统是否处于安全状态，找到的安全序列存入缓存并输出
+bool is_safe(const int current_available[]) {
+    if (!search_safe_sequence(current_available)) {
+        return false;
+    }
+    if (verbosity >= VERBOSITY_EVENT) {
+        print_safe_sequence(cached_sequence, cached_length);
+    }
+    return true;
+}
+
+// admit_batch 的 Habermann 搜索：从全部试分配的状态出发，卡住时回滚被卡住的候选中请求总量最大的一个，
+// 从卡住处继续。安全序列写入 safety_sequence，长度存入 *length；原状态不安全时返回 false
+bool admit_search(const int ids[], int k, bool granted[], int *admitted, int *length) {
+    int n = num_processes, m = num_resources;
+    int unfinished = 0;
+    for (int i = 0; i < n; i++) {
+        safety_satisfied[i] = 0;
+        unfinished += (processes[i].state != FINISH);
+    }
+    int top = 0, count = 0;
+    for (int j = 0; j < m; j++) {
+        safety_work[j] = available[j];
+        safety_cursor[j] = 0;
+        advance_cursor(j, &top);
+    }
+    while (true) {
+        while (top > 0) { // 与 find_safe_sequence 相同
+            int i = safety_stack[--top];
+            safety_sequence[count++] = i;
+            const int *allocation = processes[i].allocation;
+            add_vector(safety_work, allocation);
+            for (int j = 0; j < m; j++) {
+                if (allocation[j] > 0) {
+                    advance_cursor(j, &top);
                 }
-                finish[i] = true;                 // 标记为已完成
-                safe_sequence[count++] = temp_processes[i].pid; // 加入安全序列
-                found = true;                     // 找到一个进程
             }
         }
-        if (!found) { // 如果一轮遍历后没有找到任何可以满足的进程，则系统不安全
-            break;
+        if (count == unfinished) {
+            break;
+        }
+        // 栈空时 satisfied < m 的进程就是被卡住的进程，选出其中请求总量最大的候选
+        int victim = -1;
+        long long largest = -1;
+        for (int c = 0; c < k; c++) {
+            if (granted[c] && safety_satisfied[ids[c]] < m && batch_total[c] > largest) {
+                largest = batch_total[c];
+                victim = c;
+            }
+        }
+        if (victim == -1) { // 只有原状态不安全时才会发生
+            break;
+        }
+        int i = ids[victim];
+        PCB *p = &processes[i];
+        granted[victim] = false;
+        (*admitted)--;
+        for (int j = 0; j < m; j++) {
+            batch_rank[j] = need_rank[(size_t)j * n + i];
+        }
+        transfer_request(p, p->pending, -1);
+        update_need_order(i);
+        // Need 增大后进程在排序索引中右移：若越过游标，游标左移一格，已越过的其余进程不变
+        int satisfied = 0;
+        for (int j = 0; j < m; j++) {
+            int rank = need_rank[(size_t)j * n + i];
+            if (batch_rank[j] < safety_cursor[j] && rank >= safety_cursor[j]) {
+                safety_cursor[j]--;
+            }
+            satisfied += (rank < safety_cursor[j]);
+        }
+        safety_satisfied[i] = satisfied;
+        if (satisfied == m) {
+            safety_stack[top++] = i;
+        }
+        add_vector(safety_work, p->pending); // 回滚的请求回到 Work 中
+        for (int j = 0; j < m; j++) {
+            if (p->pending[j] > 0) {
+                advance_cursor(j, &top);
+            }
+        }
+    }
+    *length = count;
+    return count == unfinished;
+}
+
+// admit_batch 的最后一步：按顺序逐个重试未批准的候选。被回滚的请求，以及因前面的试分配装不下而没有试分配的请求，
+// 在最终状态上可能可以批准。与逐个检查相同，先沿缓存的安全序列验证 (O(n·m))，失败时才完整搜索。
+// 下标为 tested 的候选已在当前状态上检查过，跳过。返回批准的总数
+int admit_retry(const int ids[], int k, bool granted[], int admitted, int tested) {
+    for (int c = 0; c < k; c++) {
+        PCB *p = &processes[ids[c]];
+        if (granted[c] || c == tested || !less_equal(p->pending, available)) {
+            continue;
+        }
+        transfer_request(p, p->pending, 1);
+        update_need_order(ids[c]);
+        if (cached_sequence_holds(available) || search_safe_sequence(available)) {
+            granted[c] = true;
+            admitted++;
+        } else {
+            transfer_request(p, p->pending, -1);
+            update_need_order(ids[c]);
+        }
+    }
+    return admitted;
+}
+
+// 撤销 granted 中全部候选的分配
+void admit_undo(const int ids[], int k, bool granted[]) {
+    for (int c = 0; c < k; c++) {
+        if (granted[c]) {
+            transfer_request(&processes[ids[c]], processes[ids[c]].pending, -1);
+            update_need_order(ids[c]);
+            granted[c] = false;
+        }
+    }
+}
+
+// 当前状态安全、safety_sequence 中为长度 count 的安全序列时结束批量准入：
+// 被回滚的进程若全部剩余需求都不超过 Available，可以立即运行到结束，批准后仍然安全，
+// 把它放到安全序列最前面即可，不必再搜索；再建立缓存的序列并逐个重试其余候选。返回批准的总数
+int admit_finish(const int ids[], int k, bool granted[], int admitted, int count) {
+    for (int i = 0; i < num_processes; i++) {
+        safety_finish[i] = false;
+    }
+    for (int c = 0; c < k; c++) {
+        int i = ids[c];
+        if (!granted[c] && less_equal(processes[i].need, available)) {
+            transfer_request(&processes[i], processes[i].pending, 1);
+            update_need_order(i);
+            granted[c] = true;
+            admitted++;
+            safety_finish[i] = true; // 标记已移到序列前面
+        }
+    }
+    // 缓存的安全序列：后批准的进程在前（越晚批准越靠前），其余按搜索顺序
+    int length = 0;
+    for (int c = k - 1; c >= 0; c--) {
+        if (safety_finish[ids[c]]) {
+            cached_sequence[length++] = ids[c];
+        }
+    }
+    for (int q = 0; q < count; q++) {
+        if (!safety_finish[safety_sequence[q]]) {
+            cached_sequence[length++] = safety_sequence[q];
+        }
+    }
+    cached_length = length;
+    cache_valid = true;
+    return admit_retry(ids, k, granted, admitted, -1);
+}
+
+// 批量准入：ids 中的 k 个进程各自带着 pending 请求（都不超过各自的 Need），
+// 找出可以同时批准而系统仍安全的尽量大的子集，结果写入 granted，返回批准的个数。
+// 按顺序把 Available 装得下的请求都试分配，先做一次有界的逐轮扫描，安全时全部批准（常见情形）。
+// 否则做一次 Habermann 搜索 (admit_search)；搜索卡住时，被卡住的进程中一定有被试分配的候选（否则撤销全部
+// 试分配后它们仍然卡住，与原状态安全矛盾），回滚其中请求总量最大的一个，把它的请求加回 Work 后从卡住处继续搜索。
+// 已完成的进程在 Work 增加后仍可完成，不必从头再来；这需要各进程已满足的资源数，所以回滚部分不用位并行算法。
+// 贪心的回滚个别情况下批准的比逐个检查少，所以卡住时还在原状态上逐个检查一遍，取批准数多的结果
+int admit_batch(const int ids[], int k, bool granted[]) {
+    int m = num_resources;
+    int admitted = 0;
+    for (int c = 0; c < k; c++) { // 试分配装得下的请求，并记下各请求的总量
+        PCB *p = &processes[ids[c]];
+        long long total = 0;
+        for (int j = 0; j < m; j++) {
+            total += p->pending[j];
+        }
+        batch_total[c] = total;
+        granted[c] = less_equal(p->pending, available);
+        if (granted[c]) {
+            transfer_request(p, p->pending, 1);
+            update_need_order(ids[c]);
+            admitted++;
+        }
+    }
+
+    // 先逐轮扫描：全部试分配后仍然安全时，不必为回滚维护各进程已满足的资源数。
+    // 安全性随批准的请求增多只会变差，此时逐个检查也会全部批准
+    int count;
+    bool stalled;
+    if (scan_safe_sequence(available, safety_sequence, &count, true, &stalled)) {
+        return admit_finish(ids, k, granted, admitted, count);
+    }
+    if (!stalled && admitted == 1) { // 唯一试分配的请求确定不安全，拒绝它后与逐个检查相同
+        int tested = 0;
+        while (!granted[tested]) {
+            tested++;
+        }
+        admit_undo(ids, k, granted);
+        return admit_retry(ids, k, granted, 0, tested);
+    }
+    if (!admit_search(ids, k, granted, &admitted, &count)) { // 原状态已不安全，与逐个检查一样全部拒绝
+        admit_undo(ids, k, granted);
+        return 0;
+    }
+    int best = admit_finish(ids, k, granted, admitted, count);
+    for (int c = 0; c < k; c++) {
+        batch_best[c] = granted[c];
+    }
+    admit_undo(ids, k, granted);
+    int sequential = admit_retry(ids, k, granted, 0, -1); // 在原状态上逐个检查
+    if (sequential >= best) {
+        return sequential;
+    }
+    admit_undo(ids, k, granted); // 回滚搜索的结果更好，恢复它
+    for (int c = 0; c < k; c++) {
+        if (batch_best[c]) {
+            transfer_request(&processes[ids[c]], processes[ids[c]].pending, 1);
+            update_need_order(ids[c]);
+            granted[c] = true;
+        }
+    }
+    search_safe_sequence(available); // 重建缓存的序列，此状态已知安全
+    return best;
+}
+
+// --- 阻塞与唤醒 ---
+
+// 等待堆 list 中位置 a 的进程是否应排在位置 b 之前；不安全集合不排序
+bool wait_before(int list, int a, int b) {
+    return list < num_resources &&
+           processes[wait_heap[list][a]].pending[list] < processes[wait_heap[list][b]].pending[list];
+}
+
+// 交换等待堆 list 中的两个位置，并更新进程的位置
+void wait_swap(int list, int a, int b) {
+    int *heap = wait_heap[list];
+    int t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+    wait_pos[heap[a]] = a;
+    wait_pos[heap[b]] = b;
+}
+
+// 位置 pos 的进程上浮或下沉到合适的位置
+void wait_fix(int list, int pos) {
+    while (pos > 0 && wait_before(list, pos, (pos - 1) / 2)) {
+        wait_swap(list, pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+    while (true) {
+        int child = 2 * pos + 1, size = wait_size[list];
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && wait_before(list, child + 1, child)) {
+            child++;
+        }
+        if (!wait_before(list, child, pos)) {
+            break;
+        }
+        wait_swap(list, pos, child);
+        pos = child;
+    }
+}
+
+// 把进程 i 从所在的等待堆中取出
+void wait_remove(int i) {
+    int list = wait_list[i], pos = wait_pos[i];
+    int last = --wait_size[list];
+    if (pos != last) {
+        wait_swap(list, pos, last);
+        wait_fix(list, pos);
+    }
+    wait_list[i] = -1;
+}
+
+// 把阻塞进程放入等待堆：请求第一个超过 Available 的资源的堆，都不超过时放入不安全集合
+void add_waiter(PCB *p) {
+    int list = num_resources;
+    for (int j = 0; j < num_resources; j++) {
+        if (p->pending[j] > available[j]) {
+            list = j;
+            break;
+        }
+    }
+    if (wait_size[list] == wait_capacity[list]) {
+        wait_capacity[list] = wait_capacity[list] ? wait_capacity[list] * 2 : 16;
+        wait_heap[list] = (int *)realloc(wait_heap[list], sizeof(int) * wait_capacity[list]);
+        if (wait_heap[list] == NULL) {
+            perror("Failed to allocate memory");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int pos = wait_size[list]++;
+    wait_heap[list][pos] = p->pid;
+    wait_list[p->pid] = list;
+    wait_pos[p->pid] = pos;
+    wait_fix(list, pos);
+}
+
+// 阻塞进程P：记下它的请求，挂到等待链表并加入阻塞队列
+void block_process(PCB *p, const int request[]) {
+    if (request != p->pending) {
+        memcpy(p->pending, request, sizeof(int) * row_stride);
+    }
+    p->state = BLOCK;
+    p->blocked_at = block_serial++;
+    add_waiter(p);
+    block_prev[p->pid] = block_tail; // 接在阻塞队列尾部
+    block_next[p->pid] = -1;
+    if (block_tail == -1) {
+        block_head = p->pid;
+    } else {
+        block_next[block_tail] = p->pid;
+    }
+    block_tail = p->pid;
+    block_count++;
+    stats.blocks++;
+}
+
+// 把进程P从它所在的等待堆中取出，O(log n)
+void remove_waiter(PCB *p) {
+    if (wait_list[p->pid] != -1) {
+        wait_remove(p->pid);
+    }
+}
+
+// 从阻塞队列中摘下进程P，O(1)
+void remove_from_block_queue(PCB *p) {
+    int prev = block_prev[p->pid], next = block_next[p->pid];
+    if (prev == -1) {
+        block_head = next;
+    } else {
+        block_next[prev] = next;
+    }
+    if (next == -1) {
+        block_tail = prev;
+    } else {
+        block_prev[next] = prev;
+    }
+    block_count--;
+}
+
+// 按阻塞先后比较两个进程号，供 qsort 使用
+int compare_blocked_at(const void *a, const void *b) {
+    long long x = processes[*(const int *)a].blocked_at, y = processes[*(const int *)b].blocked_at;
+    return (x > y) - (x < y);
+}
+
+// 释放资源后唤醒等待者：batch_ids 中的 count 个进程为 collect_waiters 从等待堆中取出的进程。
+// 请求仍有资源不足的进程直接放回等待堆，不做安全性检查；
+// 其余进程按阻塞先后排序（admit_batch 按顺序试分配，先阻塞的先得到资源），原请求一起交给 admit_batch，
+// 只做一次安全性搜索
+void wake_waiters(int count) {
+    int k = 0; // 请求不超过 Available 的候选进程数
+    for (int c = 0; c < count; c++) {
+        int i = batch_ids[c];
+        if (less_equal(processes[i].pending, available)) {
+            batch_ids[k++] = i;
+        } else {
+            add_waiter(&processes[i]);
+        }
+    }
+    if (k == 0) {
+        return;
+    }
+    qsort(batch_ids, k, sizeof(int), compare_blocked_at);
+    if (banker_mode == DETECTION) { // 不做安全性检查，按顺序批准 Available 仍装得下的请求
+        for (int c = 0; c < k; c++) {
+            batch_granted[c] = less_equal(processes[batch_ids[c]].pending, available);
+            if (batch_granted[c]) {
+                transfer_request(&processes[batch_ids[c]], processes[batch_ids[c]].pending, 1);
+                update_need_order(batch_ids[c]);
+            }
+        }
+    } else {
+        wake_checks++;
+        int admitted = admit_batch(batch_ids, k, batch_granted);
+        if (verbosity >= VERBOSITY_EVENT) {
+            printf("批量检查 %d 个阻塞进程的请求，批准 %d 个。\n", k, admitted);
+            if (admitted > 0) {
+                print_safe_sequence(cached_sequence, cached_length);
+            }
         }
-        loop_iterations++;
     }
-
-    if (count == NUM_PROCESSES) { // 如果找到了所有进程的安全序列
-        printf("安全序列: ");
-        for (int i = 0; i < NUM_PROCESSES; i++) {
-            printf("P%d ", safe_sequence[i]);
+    for (int c = 0; c < k; c++) {
+        PCB *p = &processes[batch_ids[c]];
+        if (batch_granted[c]) {
+            log_event(EVENT_WAKE, p, p->pending, 0);
+            stats.grants++;
+            remove_from_block_queue(p);
+            p->state = WAIT;
+            enqueue(ready_queue, &ready_front, &ready_rear, p);
+        } else {
+            if (verbosity >= VERBOSITY_EVENT) {
+                printf("P%d 仍在阻塞队列中等待。\n", p->pid);
+            }
+            add_waiter(p);
         }
-        printf("\n");
-        return true;
     }
-    return false; // 没有找到安全序列
 }
 
 // 资源请求算法：尝试为进程P分配资源Request
-bool request_resources(PCB *p, int request[NUM_RESOURCES]) {
+// 无法满足或会导致不安全时，进程带着这次请求阻塞，等到有资源释放时再原样重试
+bool request_resources(PCB *p, int request[]) {
     // 1. 检查请求资源是否超过其最大需求 (Need)
     if (!less_equal(request, p->need)) {
-        printf("P%d 请求资源 (%d,%d,%d) 超过其剩余需求 (%d,%d,%d)。请求非法！\n",
-               p->pid, request[0], request[1], request[2], p->need[0], p->need[1], p->need[2]);
+        if (verbosity >= VERBOSITY_EVENT) {
+            printf("P%d 请求资源 ", p->pid);
+            print_vector(request);
+            printf(" 超过其剩余需求 ");
+            print_vector(p->need);
+            printf("。请求非法！\n");
+        }
         return false;
     }
+    stats.requests++;
 
     // 2. 检查请求资源是否超过当前可用资源 (Available)
     if (!less_equal(request, available)) {
-        printf("P%d 请求资源 (%d,%d,%d) 暂时无法满足 (Available: %d,%d,%d)，进入阻塞队列。\n",
-               p->pid, request[0], request[1], request[2], available[0], available[1], available[2]);
-        p->state = BLOCK;
-        enqueue(block_queue, &block_front, &block_rear, p);
+        log_event(EVENT_BLOCK, p, request, 0);
+        block_process(p, request);
         return false;
     }
 
-    // 3. 尝试分配资源，并进行安全性检查
+    // 3. 尝试分配资源，检测模式下直接分配，避免模式下进行安全性检查
     // 试分配：假设资源已分配
-    for (int i = 0; i < NUM_RESOURCES; i++) {
-        available[i] -= request[i];
-        p->allocation[i] += request[i];
-        p->need[i] -= request[i];
-    }
+    transfer_request(p, request, 1);
+    update_need_order(p->pid);
 
-    if (is_safe(available)) { // 如果试分配后系统仍安全
-        printf("P%d 请求资源 (%d,%d,%d) 成功分配！\n",
-               p->pid, request[0], request[1], request[2]);
+    bool granted = (banker_mode == DETECTION);
+    if (!granted) { // 先沿缓存的安全序列验证，失败时才完整搜索
+        stats.safety_checks++;
+        granted = cached_sequence_safe(available) || is_safe(available);
+    }
+    if (granted) {
+        log_event(EVENT_GRANT, p, request, 0);
+        stats.grants++;
         return true;
     } else { // 如果试分配后系统不安全，则回滚分配
-        printf("P%d 请求资源 (%d,%d,%d) 会导致系统进入不安全状态，拒绝分配。进入阻塞队列。\n",
-               p->pid, request[0], request[1], request[2]);
-        for (int i = 0; i < NUM_RESOURCES; i++) {
-            available[i] += request[i];       // 归还资源
-            p->allocation[i] -= request[i];   // 撤销分配
-            p->need[i] += request[i];         // 撤销需求更新
-        }
-        p->state = BLOCK;
-        enqueue(block_queue, &block_front, &block_rear, p);
+        log_event(EVENT_BLOCK, p, request, 1);
+        transfer_request(p, request, -1); // 归还资源，撤销分配和需求更新
+        update_need_order(p->pid);
+        block_process(p, request);
         return false;
     }
 }
 
-// 释放资源：进程完成后释放所有已分配资源
+// Available 按 released 增加之后取出可能因此得到满足的等待者，存入 batch_ids，返回个数。
+// 被释放的资源 j 的堆按 Pending[j] 从小到大取出，直到取出的请求之和超过 Available[j]：admit_batch
+// 按顺序试分配，之后的请求即使单独装得下，也会因前面的候选用掉了资源而装不下。
+// 仍有其他资源不足的进程直接移到那种资源的堆中，不占用份额。
+// with_unsafe 为 true 时再取出整个不安全集合（释放后原来不安全的请求可能变得安全）
+int collect_waiters(const int released[], bool with_unsafe) {
+    int count = 0;
+    for (int j = 0; j < num_resources; j++) {
+        if (released[j] == 0) {
+            continue;
+        }
+        long long budget = available[j];
+        while (wait_size[j] > 0 && processes[wait_heap[j][0]].pending[j] <= budget) {
+            int i = wait_heap[j][0];
+            wait_remove(i);
+            if (!less_equal(processes[i].pending, available)) {
+                add_waiter(&processes[i]);
+                continue;
+            }
+            budget -= processes[i].pending[j];
+            batch_ids[count++] = i;
+        }
+    }
+    int list = num_resources;
+    for (int pos = 0; with_unsafe && pos < wait_size[list]; pos++) {
+        int i = wait_heap[list][pos];
+        wait_list[i] = -1;
+        batch_ids[count++] = i;
+    }
+    if (with_unsafe) {
+        wait_size[list] = 0;
+    }
+    return count;
+}
+
+// 释放了 released_work 中的资源后唤醒等待者。取出的候选若有未被批准的，它占用的份额又空了出来，
+// 堆顶可能重新装得下，所以重复取出直到各堆顶都装不下为止，不会漏掉可以批准的请求。
+// 未被批准的进程放回时请求超过 Available 或进入不安全集合，而唤醒期间 Available 只减不增，不会被重复取出
+void wake_released() {
+    int count = collect_waiters(released_work, true);
+    while (count > 0) {
+        wake_waiters(count);
+        count = collect_waiters(released_work, false);
+    }
+}
+
+// 释放资源：进程完成后释放所有已分配资源，并唤醒可能因此得到满足的阻塞进程
 void release_resources(PCB *p) {
-    for (int i = 0; i < NUM_RESOURCES; i++) {
+    for (int i = 0; i < num_resources; i++) {
         available[i] += p->allocation[i]; // 将已分配资源归还给Available
+        released_work[i] = p->allocation[i];
+    }
+    for (int i = 0; i < num_resources; i++) {
         p->allocation[i] = 0;             // 清零进程的已分配资源
         p->need[i] = 0;                   // 进程已完成，需求清零
     }
-    printf("P%d 完成并释放所有资源。当前Available: (%d,%d,%d)\n",
-           p->pid, available[0], available[1], available[2]);
+    update_need_order(p->pid);
+    log_event(EVENT_FINISH, p, available, 0);
+    wake_released();
+}
+
+// --- 死锁检测与恢复 ---
+
+// 死锁检测算法：Work = Available，未阻塞的进程没有未满足的请求，都能运行下去，先释放它们的资源；
+// 再逐轮找请求不超过 Work 的阻塞进程，假设它得到满足后运行结束并释放资源。
+// 剩下的阻塞进程就是死锁进程，存入 deadlocked，返回个数。阻塞进程数为 b 时 O(m·b²)
+int detect_deadlock(int deadlocked[]) {
+    stats.detections++;
+    int *work = safety_work;
+    for (int j = 0; j < num_resources; j++) {
+        work[j] = available[j];
+    }
+    int count = 0;
+    for (int i = 0; i < num_processes; i++) {
+        if (processes[i].state == BLOCK) {
+            deadlocked[count++] = i;
+        } else if (processes[i].state != FINISH) {
+            add_vector(work, processes[i].allocation);
+        }
+    }
+    bool found = true;
+    while (found) {
+        found = false;
+        for (int c = 0; c < count; c++) {
+            PCB *p = &processes[deadlocked[c]];
+            if (less_equal(p->pending, work)) {
+                add_vector(work, p->allocation);
+                deadlocked[c--] = deadlocked[--count]; // 移出候选，剩余顺序无关
+                found = true;
+            }
+        }
+    }
+    return count;
+}
+
+// 回滚进程P：收回全部已分配资源，撤销阻塞请求，从头重新运行（Need 恢复为 Max），
+// 然后用收回的资源唤醒等待者
+void rollback_process(PCB *p) {
+    remove_from_block_queue(p);
+    remove_waiter(p);
+    long long units = 0;
+    for (int j = 0; j < num_resources; j++) {
+        units += p->allocation[j];
+        available[j] += p->allocation[j];
+        released_work[j] = p->allocation[j];
+    }
+    for (int j = 0; j < num_resources; j++) {
+        p->allocation[j] = 0;
+        p->need[j] = p->max[j];
+        p->pending[j] = 0;
+    }
+    update_need_order(p->pid);
+    p->rollbacks++;
+    stats.rollbacks++;
+    stats.wasted_units += units;
+    log_event(EVENT_ROLLBACK, p, available, units);
+    p->state = WAIT;
+    enqueue(ready_queue, &ready_front, &ready_rear, p);
+    wake_released();
+}
+
+// 检测并解除死锁：每次在占有资源的死锁进程中选一个牺牲者回滚（回滚不占资源的进程释放不了什么）——
+// 被回滚次数最少的（避免同一进程反复被回滚而饿死），其次已分配资源最少的（浪费的工作最少），
+// 直到不再有死锁。返回回滚的进程数
+int recover_deadlock() {
+    int rolled = 0;
+    int count;
+    while ((count = detect_deadlock(safety_sequence)) > 0) {
+        if (rolled == 0) {
+            stats.deadlocks++;
+        }
+        if (rolled == 0 && verbosity >= VERBOSITY_EVENT) {
+            printf("检测到死锁，涉及 %d 个进程: ", count);
+            for (int c = 0; c < count; c++) {
+                printf("P%d ", safety_sequence[c]);
+            }
+            printf("\n");
+        }
+        PCB *victim = NULL;
+        long long victim_units = 0;
+        for (int c = 0; c < count; c++) {
+            PCB *p = &processes[safety_sequence[c]];
+            long long units = 0;
+            for (int j = 0; j < num_resources; j++) {
+                units += p->allocation[j];
+            }
+            if (victim == NULL || (victim_units == 0 && units > 0) ||
+                (units > 0 && (p->rollbacks < victim->rollbacks ||
+                               (p->rollbacks == victim->rollbacks && units < victim_units)))) {
+                victim = p;
+                victim_units = units;
+            }
+        }
+        rollback_process(victim);
+        rolled++;
+    }
+    return rolled;
 }
 
 // --- 初始化和打印函数 ---
 
+// 进程私有的 xorshift 随机数：每个进程的请求序列只由种子和进程号决定，
+// 两种模式调度顺序不同，但看到的是同一组请求流。压力测试的线程也用它，rand() 不是线程安全的
+unsigned int next_random(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
 // 初始化所有进程的PCB数据
-void init_processes() {
-    srand(time(NULL)); // 初始化随机数种子
+void init_processes(unsigned int seed) {
+    srand(seed); // 初始化随机数种子
+
+    // 资源总量：前三种为 A(10)、B(15)、C(12)，其余循环使用；每 5 个进程一份
+    int scale = (num_processes + DEFAULT_PROCESSES - 1) / DEFAULT_PROCESSES;
+    for (int j = 0; j < num_resources; j++) {
+        available[j] = base_totals[j % DEFAULT_RESOURCES] * scale * resource_percent / 100;
+        if (available[j] < 1) {
+            available[j] = 1;
+        }
+    }
+    trace_header(seed, available);
 
-    printf("--- 初始化进程数据 ---\n");
-    for (int i = 0; i < NUM_PROCESSES; i++) {
+    if (verbosity >= VERBOSITY_EVENT) {
+        printf("--- 初始化进程数据 ---\n");
+    }
+    for (int i = 0; i < num_processes; i++) {
         processes[i].pid = i;
         processes[i].state = WAIT; // 初始状态为就绪
+        processes[i].rng = (seed * 2654435761u + (unsigned int)i * 40503u) | 1; // xorshift 的状态不能为 0
+        processes[i].rollbacks = 0;
+        processes[i].blocked_at = 0;
 
         // 随机生成Max需求，确保不超过总资源且合理
-        for (int j = 0; j < NUM_RESOURCES; j++) {
+        for (int j = 0; j < num_resources; j++) {
             // 资源A: 1-5, B: 1-7, C: 1-6 (相对合理范围，不超过总资源的一半)
-            processes[i].max[j] = 1 + rand() % (available[j] / 2 + 1);
+            int base = base_totals[j % DEFAULT_RESOURCES];
+            int limit = available[j] < base ? available[j] : base;
+            processes[i].max[j] = 1 + rand() % (limit / 2 + 1);
         }
 
         // 随机生成初始已分配资源 (Allocation)，保证不超Max且不超Available
-        for (int j = 0; j < NUM_RESOURCES; j++) {
+        for (int j = 0; j < num_resources; j++) {
             // 已分配资源不能超过其最大需求，也不能超过当前Available
             int max_possible_alloc = (processes[i].max[j] > available[j]) ? available[j] : processes[i].max[j];
-            processes[i].allocation[j] = rand() % (max_possible_alloc + 1);
+            processes[i].allocation[j] = initial_allocation ? rand() % (max_possible_alloc + 1) : 0;
             available[j] -= processes[i].allocation[j]; // 从Available中扣除
         }
 
         // 计算Need
-        for (int j = 0; j < NUM_RESOURCES; j++) {
+        for (int j = 0; j < num_resources; j++) {
             processes[i].need[j] = processes[i].max[j] - processes[i].allocation[j];
         }
 
         // 初始所有进程进入就绪队列
         enqueue(ready_queue, &ready_front, &ready_rear, &processes[i]);
+        trace_event(EVENT_DECLARE, i, processes[i].max, 0);
+        trace_event(EVENT_GRANT, i, processes[i].allocation, 0);
 
-        printf("P%d: Max=(%d,%d,%d), Allocation=(%d,%d,%d), Need=(%d,%d,%d)\n",
-               processes[i].pid,
-               processes[i].max[0], processes[i].max[1], processes[i].max[2],
-               processes[i].allocation[0], processes[i].allocation[1], processes[i].allocation[2],
-               processes[i].need[0], processes[i].need[1], processes[i].need[2]);
+        if (verbosity >= VERBOSITY_EVENT && num_processes <= PCB_TABLE_LIMIT) {
+            printf("P%d: Max=", processes[i].pid);
+            print_vector(processes[i].max);
+            printf(", Allocation=");
+            print_vector(processes[i].allocation);
+            printf(", Need=");
+            print_vector(processes[i].need);
+            printf("\n");
+        }
     }
-    printf("初始 Available: (%d,%d,%d)\n", available[0], available[1], available[2]);
-    if (!is_safe(available)) {
+    build_need_order();
+    if (verbosity >= VERBOSITY_RESULT) {
+        printf("初始 Available: ");
+        print_vector(available);
+        printf("\n");
+    }
+    if (!is_safe(available) && verbosity >= VERBOSITY_RESULT) {
         printf("警告：初始状态可能不安全！这可能会导致很快有进程阻塞。\n");
     }
-    printf("------------------------\n\n");
+    if (verbosity >= VERBOSITY_EVENT) {
+        printf("------------------------\n\n");
+    }
+}
+
+// 打印 PCB 表中的一个资源向量，每个分量占两位
+void print_table_vector(const int v[]) {
+    printf("(");
+    for (int j = 0; j < num_resources; j++) {
+        printf(j ? ",%2d" : "%2d", v[j]);
+    }
+    printf(")");
 }
 
 // 打印当前系统状态和所有进程的PCB信息
 void print_status() {
     printf("\n--- 当前系统状态 ---\n");
-    printf("可用资源 (Available): (%d,%d,%d)\n", available[0], available[1], available[2]);
+    printf("可用资源 (Available): ");
+    print_vector(available);
+    printf("\n");
 
     printf("正在运行的进程: ");
     if (running_process) {
@@ -259,21 +1809,14 @@ void print_status() {
     }
 
     printf("就绪队列 (Ready Queue): ");
-    if (is_queue_empty(ready_front, ready_rear)) {
-        printf("空\n");
-    } else {
-        for (int i = ready_front; i <= ready_rear; i++) {
-            printf("P%d ", ready_queue[i]->pid);
-        }
-        printf("\n");
-    }
+    print_queue(ready_queue, ready_front, ready_rear);
 
     printf("阻塞队列 (Block Queue): ");
-    if (is_queue_empty(block_front, block_rear)) {
+    if (block_head == -1) {
         printf("空\n");
     } else {
-        for (int i = block_front; i <= block_rear; i++) {
-            printf("P%d ", block_queue[i]->pid);
+        for (int i = block_head; i != -1; i = block_next[i]) {
+            printf("P%d ", i);
         }
         printf("\n");
     }
@@ -288,87 +1831,683 @@ void print_status() {
         printf("\n");
     }
 
+    if (num_processes > PCB_TABLE_LIMIT) { // 进程太多时只输出队列
+        printf("------------------------\n\n");
+        return;
+    }
     printf("所有进程PCB信息:\n");
-    printf("PID | State  | Max (A,B,C) | Alloc (A,B,C) | Need (A,B,C)\n");
+    printf("PID | State  | Max ");
+    print_resource_names();
+    printf(" | Alloc ");
+    print_resource_names();
+    printf(" | Need ");
+    print_resource_names();
+    printf("\n");
     printf("----------------------------------------------------------------\n");
-    for (int i = 0; i < NUM_PROCESSES; i++) {
-        printf("P%-2d | %-6s | (%2d,%2d,%2d) | (%2d,%2d,%2d) | (%2d,%2d,%2d)\n",
-               processes[i].pid,
+    for (int i = 0; i < num_processes; i++) {
+        printf("P%-2d | %-6s | ", processes[i].pid,
                (processes[i].state == WAIT) ? "Wait" :
                (processes[i].state == RUN) ? "Run" :
-               (processes[i].state == BLOCK) ? "Block" : "Finish",
-               processes[i].max[0], processes[i].max[1], processes[i].max[2],
-               processes[i].allocation[0], processes[i].allocation[1], processes[i].allocation[2],
-               processes[i].need[0], processes[i].need[1], processes[i].need[2]);
+               (processes[i].state == BLOCK) ? "Block" : "Finish");
+        print_table_vector(processes[i].max);
+        printf(" | ");
+        print_table_vector(processes[i].allocation);
+        printf(" | ");
+        print_table_vector(processes[i].need);
+        printf("\n");
     }
     printf("------------------------\n\n");
 }
 
-// --- 主模拟循环 ---
-int main() {
-    init_processes();
+// --- 线程安全的银行家对象 ---
+// 供多个真实线程并发调用 request/release，状态都在对象内部，不使用上面的全局变量。
+// 快速路径：若进程剩余的全部需求 Need 都不超过 Available，它可以立即运行到结束并释放全部资源，
+// 此后 Work 只会比原安全序列开始时更多，所以在安全状态下批准它的任何合法请求后仍然安全，
+// 只需 O(m) 检查，持有状态锁的时间很短。
+// 其他请求走完整检查：由 check_lock 串行化，在状态快照上进行，检查期间不持有状态锁，
+// 其他线程的快速路径和释放可以继续进行；提交时若 version 已变化则重新检查，
+// 连续失败 BANKER_MAX_RETRIES 次后改为持有状态锁检查，保证前进。
+// 暂时无法满足或会导致不安全的请求在条件变量上睡眠，直到有进程释放资源。
 
-    int time_slice = 1; // 每个进程运行的时间片 (这里简化为一次调度)
-    int turn = 0;       // 调度轮次计数
+#define BANKER_MAX_RETRIES 3
 
-    while (finish_count < NUM_PROCESSES) { // 当未完成进程数小于总进程数时，继续模拟
-        turn++;
-        printf("=========== 调度轮次 %d ===========\n", turn);
-
-        // 尝试唤醒阻塞队列中的进程
-        // 遍历阻塞队列，尝试分配资源
-        if (!is_queue_empty(block_front, block_rear)) {
-            printf("尝试唤醒阻塞队列中的进程...\n");
-            // 注意：这里需要创建一个临时队列来重新构建阻塞队列，因为可能会有进程被移除
-            PCB *temp_block_queue[NUM_PROCESSES];
-            int temp_block_front = -1, temp_block_rear = -1;
-
-            while (!is_queue_empty(block_front, block_rear)) {
-                PCB *p = dequeue(block_queue, &block_front, &block_rear); // 从原阻塞队列取出
-                if (p == NULL) break;
-
-                int request[NUM_RESOURCES];
-                bool can_request = true;
-                for(int j=0; j<NUM_RESOURCES; j++){
-                     // 随机请求 Need 内的一部分资源，但不能超过当前Available
-                     request[j] = rand() % (p->need[j] + 1);
-                     if (request[j] > available[j]) { // 如果随机请求超过Available，则无法满足
-                         can_request = false;
-                         break;
-                     }
+typedef struct {
+    int num_processes, num_resources;
+    int stride;                 // 资源向量的存储长度（补齐到 VECTOR_LANES）
+    int *total;                 // 各类资源总量
+    int *available;             // 以下均受 lock 保护
+    int *max, *allocation, *need; // 矩阵，每行 stride 个 int
+    unsigned long version;      // 每次状态改变（分配、释放、声明）加一
+    pthread_mutex_t lock;       // 保护状态，临界区都是 O(m) 或一次快照复制
+    pthread_cond_t released;    // 有进程释放了资源
+    pthread_mutex_t check_lock; // 串行化完整安全性检查
+    bool fast_path;             // 是否启用快速路径（基准测试对照用）
+    // 完整检查的快照与工作区，仅在持有 check_lock 时访问
+    int *snap_available, *snap_allocation, *snap_need, *work;
+    bool *finish;
+    // 各进程本次请求补齐对齐后的副本，每行 stride 个 int，只由该进程自己的线程访问
+    int *requests;
+    // 统计，受 lock 保护
+    long long grants, fast_grants, full_checks, retries, waits;
+} Banker;
+
+// 按 stride 分配 count 个对齐且清零的资源向量
+int* banker_vectors(const Banker *b, size_t count) {
+    return checked_aligned_alloc(sizeof(int) * count * b->stride);
+}
+
+// 创建 n 个进程、m 类资源的银行家对象，total 为各类资源总量；进程的最大需求由 banker_declare 声明
+Banker* banker_create(int n, int m, const int total[]) {
+    Banker *b = (Banker *)checked_malloc(sizeof(Banker));
+    memset(b, 0, sizeof(Banker));
+    b->num_processes = n;
+    b->num_resources = m;
+    b->stride = (m + VECTOR_LANES - 1) / VECTOR_LANES * VECTOR_LANES;
+    b->total = banker_vectors(b, 1);
+    b->available = banker_vectors(b, 1);
+    b->max = banker_vectors(b, n);
+    b->allocation = banker_vectors(b, n);
+    b->need = banker_vectors(b, n);
+    b->snap_available = banker_vectors(b, 1);
+    b->snap_allocation = banker_vectors(b, n);
+    b->snap_need = banker_vectors(b, n);
+    b->work = banker_vectors(b, 1);
+    b->requests = banker_vectors(b, n);
+    b->finish = (bool *)checked_malloc(sizeof(bool) * n);
+    for (int j = 0; j < m; j++) {
+        b->total[j] = total[j];
+        b->available[j] = total[j];
+    }
+    b->fast_path = true;
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->released, NULL);
+    pthread_mutex_init(&b->check_lock, NULL);
+    return b;
+}
+
+void banker_destroy(Banker *b) {
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->released);
+    pthread_mutex_destroy(&b->check_lock);
+    free_vectors(b->total);
+    free_vectors(b->available);
+    free_vectors(b->max);
+    free_vectors(b->allocation);
+    free_vectors(b->need);
+    free_vectors(b->snap_available);
+    free_vectors(b->snap_allocation);
+    free_vectors(b->snap_need);
+    free_vectors(b->work);
+    free_vectors(b->requests);
+    free(b->finish);
+    free(b);
+}
+
+// 进程 pid 声明新的最大需求（此时它不能持有资源）。Max 不超过资源总量时，
+// 新进程总可以排在安全序列最后，所以声明不会破坏安全性
+bool banker_declare(Banker *b, int pid, const int max[]) {
+    size_t row = (size_t)pid * b->stride;
+    bool ok = true;
+    pthread_mutex_lock(&b->lock);
+    for (int j = 0; j < b->num_resources; j++) {
+        if (b->allocation[row + j] != 0 || max[j] < 0 || max[j] > b->total[j]) {
+            ok = false;
+        }
+    }
+    if (ok) {
+        for (int j = 0; j < b->num_resources; j++) {
+            b->max[row + j] = max[j];
+            b->need[row + j] = max[j];
+        }
+        b->version++;
+    }
+    pthread_mutex_unlock(&b->lock);
+    return ok;
+}
+
+// 在快照上运行逐轮扫描的安全性算法（snap_* 已包含试分配）
+bool banker_snapshot_safe(Banker *b) {
+    int n = b->num_processes, stride = b->stride;
+    memcpy(b->work, b->snap_available, sizeof(int) * stride);
+    for (int i = 0; i < n; i++) {
+        b->finish[i] = false;
+    }
+    int count = 0;
+    bool found = true;
+    while (count < n && found) {
+        found = false;
+        for (int i = 0; i < n; i++) {
+            size_t row = (size_t)i * stride;
+            if (!b->finish[i] && vector_less_equal(b->snap_need + row, b->work, stride)) {
+                vector_add(b->work, b->snap_allocation + row, stride);
+                b->finish[i] = true;
+                count++;
+                found = true;
+            }
+        }
+    }
+    return count == n;
+}
+
+// 把请求计入状态：Available -= Request, Allocation += Request, Need -= Request（调用者持有 lock）
+void banker_apply(Banker *b, int pid, const int request[]) {
+    size_t row = (size_t)pid * b->stride;
+    vector_sub(b->available, request, b->stride);
+    vector_add(b->allocation + row, request, b->stride);
+    vector_sub(b->need + row, request, b->stride);
+    b->version++;
+    b->grants++;
+}
+
+// 完整检查：request 为 banker_request 补齐后的请求行。
+// 调用者持有 lock，返回时仍持有 lock。授权成功返回 true，不安全返回 false
+bool banker_full_check(Banker *b, int pid, const int request[]) {
+    int n = b->num_processes, stride = b->stride;
+    size_t row = (size_t)pid * stride;
+    pthread_mutex_unlock(&b->lock);
+    pthread_mutex_lock(&b->check_lock); // 锁顺序：check_lock 在 lock 之前
+    pthread_mutex_lock(&b->lock);
+    for (int attempt = 0; ; attempt++) {
+        if (!vector_less_equal(request, b->available, stride)) {
+            pthread_mutex_unlock(&b->check_lock); // 等待期间资源被其他进程取走，回到等待
+            return false;
+        }
+        memcpy(b->snap_available, b->available, sizeof(int) * stride);
+        memcpy(b->snap_allocation, b->allocation, sizeof(int) * n * stride);
+        memcpy(b->snap_need, b->need, sizeof(int) * n * stride);
+        unsigned long version = b->version;
+        bool hold_lock = attempt >= BANKER_MAX_RETRIES; // 多次被打断后持锁检查，保证前进
+        if (!hold_lock) {
+            pthread_mutex_unlock(&b->lock);
+        }
+        vector_sub(b->snap_available, request, stride); // 在快照上试分配
+        vector_add(b->snap_allocation + row, request, stride);
+        vector_sub(b->snap_need + row, request, stride);
+        bool safe = banker_snapshot_safe(b);
+        if (!hold_lock) {
+            pthread_mutex_lock(&b->lock);
+        }
+        b->full_checks++;
+        if (b->version == version) { // 检查期间状态未变，结论有效
+            if (safe) {
+                banker_apply(b, pid, request);
+            }
+            pthread_mutex_unlock(&b->check_lock);
+            return safe;
+        }
+        b->retries++;
+    }
+}
+
+// 进程 pid 请求资源 request。与 banker_declare 的 max 一样，request 是 m 个 int 的普通数组，
+// 先复制到该进程补齐对齐的请求行再交给向量运算。请求有负分量或超过其剩余需求时返回 false；
+// 否则阻塞直到可以安全地分配，分配后返回 true
+bool banker_request(Banker *b, int pid, const int caller_request[]) {
+    int stride = b->stride;
+    size_t row = (size_t)pid * stride;
+    const int *need = b->need + row; // 只有进程自己的线程会改变它的 Need
+    int *request = b->requests + row; // 补齐部分始终为 0
+    for (int j = 0; j < b->num_resources; j++) {
+        if (caller_request[j] < 0) { // 负的请求相当于不经释放就归还资源，会使 Available 和 Need 失真
+            return false;
+        }
+    }
+    memcpy(request, caller_request, sizeof(int) * b->num_resources);
+    pthread_mutex_lock(&b->lock);
+    if (!vector_less_equal(request, need, stride)) {
+        pthread_mutex_unlock(&b->lock);
+        return false;
+    }
+    while (true) {
+        if (vector_less_equal(request, b->available, stride)) {
+            if (b->fast_path && vector_less_equal(need, b->available, stride)) { // 可以运行到结束，一定安全
+                banker_apply(b, pid, request);
+                b->fast_grants++;
+                break;
+            }
+            if (banker_full_check(b, pid, request)) {
+                break;
+            }
+        }
+        b->waits++;
+        pthread_cond_wait(&b->released, &b->lock); // 睡眠到有进程释放资源
+    }
+    pthread_mutex_unlock(&b->lock);
+    return true;
+}
+
+// 进程 pid 完成，释放全部资源，并唤醒等待的请求者
+void banker_release(Banker *b, int pid) {
+    size_t row = (size_t)pid * b->stride;
+    pthread_mutex_lock(&b->lock);
+    vector_add(b->available, b->allocation + row, b->stride);
+    memset(b->allocation + row, 0, sizeof(int) * b->stride);
+    memset(b->max + row, 0, sizeof(int) * b->stride);
+    memset(b->need + row, 0, sizeof(int) * b->stride);
+    b->version++;
+    pthread_cond_broadcast(&b->released);
+    pthread_mutex_unlock(&b->lock);
+}
+
+// --- 安全性检查基准测试 ---
+
+double elapsed_seconds(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// 构造一个随机的安全状态：按随机顺序 perm 依次完成恰好可行，Available 取使该顺序可行的最小值
+void build_safe_state() {
+    int n = num_processes, m = num_resources;
+    int *perm = (int *)checked_malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        perm[i] = i;
+        processes[i].pid = i;
+        processes[i].state = WAIT;
+        for (int j = 0; j < m; j++) {
+            processes[i].max[j] = 1 + rand() % 20;
+            processes[i].allocation[j] = rand() % (processes[i].max[j] + 1);
+            processes[i].need[j] = processes[i].max[j] - processes[i].allocation[j];
+        }
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int k = rand() % (i + 1);
+        int t = perm[i];
+        perm[i] = perm[k];
+        perm[k] = t;
+    }
+    for (int j = 0; j < m; j++) {
+        long long released = 0, lacking = 0; // 前面进程释放的资源总量，以及为此还需补足的 Available
+        for (int k = 0; k < n; k++) {
+            int i = perm[k];
+            if (processes[i].need[j] - released > lacking) {
+                lacking = processes[i].need[j] - released;
+            }
+            released += processes[i].allocation[j];
+        }
+        available[j] = (int)lacking;
+    }
+    free(perm);
+}
+
+// 构造链式安全状态：Available 为 0，每个进程各类资源已分配 1 个，
+// 进程 n-1-k 还需要 k 个，只有前面 k 个进程都完成后才能运行。
+// 唯一的安全序列为进程号降序，逐轮扫描每轮只能找到一个进程，是它的最坏情况
+void build_chain_state() {
+    int n = num_processes, m = num_resources;
+    for (int i = 0; i < n; i++) {
+        processes[i].pid = i;
+        processes[i].state = WAIT;
+        for (int j = 0; j < m; j++) {
+            processes[i].allocation[j] = 1;
+            processes[i].need[j] = n - 1 - i;
+            processes[i].max[j] = n - i;
+        }
+    }
+    for (int j = 0; j < m; j++) {
+        available[j] = 0;
+    }
+}
+
+// 重复运行安全性算法约 0.2 秒，返回每次的平均耗时 (ms)
+double time_safety_check(bool (*check)(const int[], int[], int *), bool *safe) {
+    int length = 0, repeats = 0;
+    clock_t start = clock();
+    do {
+        *safe = check(available, safety_sequence, &length);
+        repeats++;
+    } while (elapsed_seconds(start) < 0.2);
+    return elapsed_seconds(start) * 1000 / repeats;
+}
+
+// 在 n 个进程、m 种资源的安全状态上比较各安全性算法的耗时
+void run_safety_benchmark(int m, unsigned int seed) {
+    static const int sizes[] = {1000, 10000, 100000, 1000000};
+    srand(seed);
+    printf("安全性检查基准测试：%d 种资源，随机种子 %u\n", m, seed);
+    printf("%-10s%-10s%-16s%-16s%-16s%-16s%-16s%s\n", "进程数", "状态", "建立索引(ms)", "Habermann(ms)", "位并行(ms)",
+           "先扫描(ms)", "逐轮扫描(ms)", "结果");
+    for (int s = 0; s < 4; s++) {
+        if ((long long)sizes[s] * m > 64000000LL) { // 每个矩阵元素约占 28 字节（7 个 n×m 的 int 数组），限制在 2 GB 以内
+            break;
+        }
+        for (int chain = 0; chain <= 1; chain++) {
+            num_processes = sizes[s];
+            num_resources = m;
+            alloc_banker();
+            if (chain) {
+                build_chain_state();
+            } else {
+                build_safe_state();
+            }
+
+            clock_t start = clock();
+            build_need_order();
+            double sort_ms = elapsed_seconds(start) * 1000;
+
+            bool safe = false, safe_bits = false, safe_hybrid = false;
+            double fast_ms = time_safety_check(find_safe_sequence, &safe);
+            double bits_ms = time_safety_check(find_safe_sequence_bitset, &safe_bits);
+            double hybrid_ms = time_safety_check(find_safe_sequence_hybrid, &safe_hybrid); // is_safe 使用的组合
+            safe = safe && safe_bits && safe_hybrid;
+
+            printf("%-10d%-10s%-16.2f%-16.3f%-16.3f%-16.3f", num_processes, chain ? "链式" : "随机", sort_ms, fast_ms,
+                   bits_ms, hybrid_ms);
+            if (num_processes <= (chain ? 10000 : 100000)) { // 逐轮扫描在链式状态下为平方复杂度，规模大时耗时过长
+                int length = 0;
+                start = clock();
+                bool safe_passes = find_safe_sequence_passes(available, safety_sequence, &length);
+                printf("%-16.3f", elapsed_seconds(start) * 1000);
+                safe = safe && safe_passes;
+            } else {
+                printf("%-16s", "-");
+            }
+            printf("%s\n", safe ? "安全" : "不安全");
+            free_banker();
+        }
+    }
+}
+
+// --- 向量运算基准测试 ---
+
+// 标量对照版本：与向量化之前的逐个资源循环相同
+bool less_equal_scalar(const int a[], const int b[]) {
+    for (int i = 0; i < num_resources; i++) {
+        if (a[i] > b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void add_vector_scalar(int dst[], const int src[]) {
+    for (int i = 0; i < num_resources; i++) {
+        dst[i] += src[i];
+    }
+}
+
+void transfer_request_scalar(PCB *p, const int request[], int sign) {
+    for (int i = 0; i < num_resources; i++) {
+        available[i] -= sign * request[i];
+        p->allocation[i] += sign * request[i];
+        p->need[i] -= sign * request[i];
+    }
+}
+
+// 在 m = 8、32、128 类资源上比较向量化与标量的 less_equal、Work 累加和试分配/回滚，单位为 ns/次
+// less_equal 比较的向量都满足 Need <= Work，必须扫描完整个向量，是它的最坏情况
+void run_vector_benchmark(unsigned int seed) {
+    static const int widths[] = {8, 32, 128};
+    const char *kernel =
+#if defined(__AVX2__)
+        "AVX2";
+#elif defined(__SSE2__)
+        "SSE2";
+#else
+        "标量";
+#endif
+    srand(seed);
+    printf("资源向量运算基准测试：向量指令 %s，随机种子 %u\n", kernel, seed);
+    printf("%-8s%-14s%-14s%-10s%-14s%-14s%-10s%-14s%-14s%s\n", "资源数",
+           "比较(标量)", "比较(向量)", "加速比", "累加(标量)", "累加(向量)", "加速比",
+           "试分配(标量)", "试分配(向量)", "加速比");
+    for (int w = 0; w < 3; w++) {
+        num_processes = 1024;
+        num_resources = widths[w];
+        alloc_banker();
+        int *request = alloc_vectors(1);
+        for (int i = 0; i < num_processes; i++) {
+            for (int j = 0; j < num_resources; j++) {
+                processes[i].need[j] = rand() % 20;
+                processes[i].allocation[j] = rand() % 20;
+            }
+        }
+        for (int j = 0; j < num_resources; j++) {
+            safety_work[j] = 1 << 28; // 足够大，所有进程都满足 Need <= Work
+            available[j] = 1 << 28;
+            request[j] = rand() % 5;
+        }
+
+        double ns[6];
+        for (int k = 0; k < 6; k++) {
+            long long ops = 0;
+            int hits = 0;
+            clock_t start = clock();
+            do {
+                for (int i = 0; i < num_processes; i++) {
+                    PCB *p = &processes[i];
+                    switch (k) {
+                    case 0: hits += less_equal_scalar(p->need, safety_work); break;
+                    case 1: hits += less_equal(p->need, safety_work); break;
+                    case 2: add_vector_scalar(safety_work, p->allocation); break;
+                    case 3: add_vector(safety_work, p->allocation); break;
+                    case 4: transfer_request_scalar(p, request, 1); transfer_request_scalar(p, request, -1); break;
+                    default: transfer_request(p, request, 1); transfer_request(p, request, -1); break;
+                    }
+                }
+                ops += num_processes;
+            } while (elapsed_seconds(start) < 0.1);
+            ns[k] = elapsed_seconds(start) * 1e9 / ops;
+            if (k <= 1 && hits != ops) {
+                printf("警告：比较结果与预期不符\n");
+            }
+            if (k == 3) { // 两轮累加后 Work 增大，恢复为初始值，避免后续溢出
+                for (int j = 0; j < num_resources; j++) {
+                    safety_work[j] = 1 << 28;
+                }
+            }
+        }
+        printf("%-8d%-14.2f%-14.2f%-10.2f%-14.2f%-14.2f%-10.2f%-14.2f%-14.2f%.2f\n", num_resources,
+               ns[0], ns[1], ns[0] / ns[1], ns[2], ns[3], ns[2] / ns[3], ns[4], ns[5], ns[4] / ns[5]);
+        free_vectors(request);
+        free_banker();
+    }
+}
+
+// --- 批量准入基准测试 ---
+
+// 为随机安全状态生成 k 个阻塞请求：各取自不同进程，不超过其 Need，单独不超过 Available
+int build_burst(int k) {
+    int count = 0;
+    for (int i = 0; i < num_processes && count < k; i++) {
+        if (rand() % (num_processes - i) >= k - count) { // 从剩余进程中等概率抽取
+            continue;
+        }
+        for (int j = 0; j < num_resources; j++) {
+            int limit = processes[i].need[j] < available[j] ? processes[i].need[j] : available[j];
+            processes[i].pending[j] = rand() % (limit + 1);
+        }
+        batch_ids[count++] = i;
+    }
+    return count;
+}
+
+// 在突发的阻塞请求上比较逐个试分配+安全性检查与 admit_batch 的耗时和批准数
+void run_batch_benchmark(unsigned int seed) {
+    static const int bursts[] = {10, 100, 1000};
+    const int n = 10000, m = 16, slack = 40; // Available 在最小安全值之上再加 slack，使部分请求可以批准
+    printf("批量准入基准测试：%d 个进程，%d 类资源，随机种子 %u\n", n, m, seed);
+    printf("%-10s%-14s%-12s%-14s%-12s%s\n", "请求数", "逐个(ms)", "逐个批准", "批量(ms)", "批量批准", "加速比");
+    for (int b = 0; b < 3; b++) {
+        double ms[2];
+        int granted_count[2];
+        for (int mode = 0; mode < 2; mode++) { // 两种方式使用相同的状态和请求
+            srand(seed + b);
+            num_processes = n;
+            num_resources = m;
+            alloc_banker();
+            build_safe_state();
+            for (int j = 0; j < m; j++) {
+                available[j] += slack;
+            }
+            build_need_order();
+            int k = build_burst(bursts[b]);
+            int granted = 0, length;
+            clock_t start = clock();
+            if (mode == 0) {
+                for (int c = 0; c < k; c++) {
+                    PCB *p = &processes[batch_ids[c]];
+                    if (!less_equal(p->pending, available)) { // 前面的批准已用掉资源
+                        continue;
+                    }
+                    transfer_request(p, p->pending, 1);
+                    update_need_order(p->pid);
+                    if (find_safe_sequence_hybrid(available, safety_sequence, &length)) { // 与 is_safe 相同的检查
+                        granted++;
+                    } else {
+                        transfer_request(p, p->pending, -1);
+                        update_need_order(p->pid);
+                    }
                 }
+            } else {
+                granted = admit_batch(batch_ids, k, batch_granted);
+            }
+            ms[mode] = elapsed_seconds(start) * 1000;
+            granted_count[mode] = granted;
+            free_banker();
+        }
+        printf("%-10d%-14.2f%-12d%-14.2f%-12d%.1f\n", bursts[b], ms[0], granted_count[0], ms[1], granted_count[1],
+               ms[1] > 0 ? ms[0] / ms[1] : 0.0);
+    }
+}
+
+// --- 并发压力测试 ---
+
+#define STRESS_RESOURCES 8     // 压力测试的资源种类数
+#define STRESS_SECONDS 0.3     // 每种配置的运行时长（秒）
+
+// 单调时钟，单位秒
+double wall_seconds() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+typedef struct {
+    Banker *banker;
+    int pid;
+    unsigned int rng;
+    atomic_bool *stop;
+    long long jobs; // 完成的作业数（声明、逐步申请到最大需求、释放）
+} StressWorker;
+
+// 每个线程扮演一个进程：反复声明随机的最大需求，分几次随机申请直到达到最大需求，然后释放全部资源
+void* stress_worker(void *arg) {
+    StressWorker *w = (StressWorker *)arg;
+    Banker *b = w->banker;
+    int m = b->num_resources;
+    int *max = (int *)checked_malloc(sizeof(int) * m);
+    int *request = (int *)checked_malloc(sizeof(int) * m);
+    const int *need = b->need + (size_t)w->pid * b->stride;
+    while (!atomic_load(w->stop)) {
+        for (int j = 0; j < m; j++) {
+            max[j] = 1 + next_random(&w->rng) % (b->total[j] / 2);
+        }
+        banker_declare(b, w->pid, max);
+        bool done = false;
+        while (!done) {
+            done = true;
+            for (int j = 0; j < m; j++) { // 只有本线程会改变自己的 Need，可以不加锁读取
+                request[j] = need[j] == 0 ? 0 : 1 + next_random(&w->rng) % need[j];
+                done = done && request[j] == need[j];
+            }
+            banker_request(b, w->pid, request);
+        }
+        banker_release(b, w->pid);
+        w->jobs++;
+    }
+    free(max);
+    free(request);
+    return NULL;
+}
 
-                if (can_request && request_resources(p, request)) { // 尝试请求资源 (会调用银行家算法)
-                    printf("P%d 从阻塞队列唤醒，并成功分配资源，进入就绪队列。\n", p->pid);
-                    p->state = WAIT;
-                    enqueue(ready_queue, &ready_front, &ready_rear, p);
-                } else {
-                    // 如果仍然无法满足或导致不安全，重新放入阻塞队列
-                    printf("P%d 仍在阻塞队列中等待。\n", p->pid);
-                    enqueue(temp_block_queue, &temp_block_front, &temp_block_rear, p);
+// 线程数从 1 倍增到 max_threads，分别在启用和关闭快速路径时运行压力测试，输出每秒授权次数
+void run_thread_benchmark(int max_threads, unsigned int seed) {
+    printf("并发压力测试：%d 类资源，每种配置运行 %.1f 秒，随机种子 %u\n", STRESS_RESOURCES, STRESS_SECONDS, seed);
+    printf("%-8s%-10s%-14s%-12s%-12s%-12s%-10s%s\n", "线程数", "快速路径", "授权次数/秒", "作业/秒",
+           "快速路径%", "完整检查", "重试", "等待");
+    int total[STRESS_RESOURCES];
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        for (int fast = 1; fast >= 0; fast--) {
+            for (int j = 0; j < STRESS_RESOURCES; j++) {
+                total[j] = 4 * threads + 10; // 资源随线程数增加，但不足以让所有进程同时达到最大需求
+            }
+            Banker *b = banker_create(threads, STRESS_RESOURCES, total);
+            b->fast_path = fast;
+            atomic_bool stop = false;
+            pthread_t *ids = (pthread_t *)checked_malloc(sizeof(pthread_t) * threads);
+            StressWorker *workers = (StressWorker *)checked_malloc(sizeof(StressWorker) * threads);
+            double start = wall_seconds();
+            for (int t = 0; t < threads; t++) {
+                workers[t] = (StressWorker){b, t, seed * 2654435761u + t * 40503u + 1, &stop, 0};
+                if (pthread_create(&ids[t], NULL, stress_worker, &workers[t]) != 0) {
+                    perror("pthread_create");
+                    exit(EXIT_FAILURE);
                 }
             }
-            // 将临时阻塞队列的内容复制回主阻塞队列
-            block_front = temp_block_front;
-            block_rear = temp_block_rear;
-            for(int i = (block_front == -1 ? 0 : block_front); i <= block_rear; i++) {
-                block_queue[i] = temp_block_queue[i];
+            while (wall_seconds() - start < STRESS_SECONDS) {
+                struct timespec pause = {0, 10000000}; // 10 ms
+                nanosleep(&pause, NULL);
             }
+            atomic_store(&stop, true);
+            long long jobs = 0;
+            for (int t = 0; t < threads; t++) {
+                pthread_join(ids[t], NULL);
+                jobs += workers[t].jobs;
+            }
+            double elapsed = wall_seconds() - start;
+            printf("%-8d%-10s%-14.0f%-12.0f%-12.1f%-12lld%-10lld%lld\n", threads, fast ? "启用" : "关闭",
+                   b->grants / elapsed, jobs / elapsed, b->grants ? 100.0 * b->fast_grants / b->grants : 0.0,
+                   b->full_checks, b->retries, b->waits);
+            free(ids);
+            free(workers);
+            banker_destroy(b);
+        }
+    }
+}
+
+// --- 主模拟循环 ---
+
+// 运行调度模拟直到所有进程完成。避免模式下所有进程都阻塞时停止；检测模式下此时检测并解除死锁后继续
+void run_simulation() {
+    int time_slice = 1; // 每个进程运行的时间片 (这里简化为一次调度)
+    int turn = 0;       // 调度轮次计数
+    int *request = alloc_vectors(1); // 本轮的随机请求，各轮共用
+
+    while (finish_count < num_processes) { // 当未完成进程数小于总进程数时，继续模拟
+        turn++;
+        stats.rounds = turn;
+        stats.blocked_rounds += block_count; // 本轮开始时仍在阻塞的进程各等待一轮
+        if (verbosity >= VERBOSITY_EVENT) {
+            printf("=========== 调度轮次 %d ===========\n", turn);
+        }
+
+        if (banker_mode == DETECTION && detect_interval > 0 && turn % detect_interval == 0) {
+            recover_deadlock(); // 定期检测，不必等到所有进程都阻塞
         }
 
+        // 阻塞进程不再每轮重试：有进程完成并释放资源时，release_resources 只唤醒请求可能得到满足的进程
 
         // 时间片轮转调度：从就绪队列中取出进程执行
         running_process = dequeue(ready_queue, &ready_front, &ready_rear);
 
         if (running_process) {
             running_process->state = RUN;
-            printf("P%d 正在运行。\n", running_process->pid);
+            if (verbosity >= VERBOSITY_EVENT) {
+                printf("P%d 正在运行。\n", running_process->pid);
+            }
 
             bool process_finished_in_this_turn = false;
 
             // 检查进程是否已达到最大需求（Need是否为0）
             bool all_needed_allocated = true;
-            for(int i=0; i<NUM_RESOURCES; i++){
+            for(int i=0; i<num_resources; i++){
                 if(running_process->need[i] > 0){
                     all_needed_allocated = false;
                     break;
@@ -376,24 +2515,23 @@ int main() {
             }
 
             if(all_needed_allocated){ // 如果已完成
-                printf("P%d 已达到最大需求，即将完成。\n", running_process->pid);
+                if (verbosity >= VERBOSITY_EVENT) {
+                    printf("P%d 已达到最大需求，即将完成。\n", running_process->pid);
+                }
                 running_process->state = FINISH;
                 finish_queue[finish_count++] = running_process; // 直接加入完成队列
                 release_resources(running_process);
                 process_finished_in_this_turn = true;
             } else { // 否则，随机申请资源
-                printf("P%d 随机申请资源...\n", running_process->pid);
-                int request[NUM_RESOURCES];
-                for (int i = 0; i < NUM_RESOURCES; i++) {
-                    request[i] = rand() % (running_process->need[i] + 1); // 随机申请 Need 内的一部分
+                for (int i = 0; i < num_resources; i++) {
+                    request[i] = next_random(&running_process->rng) % (running_process->need[i] + 1); // 随机申请 Need 内的一部分
                 }
-                printf("P%d 请求: (%d,%d,%d)\n",
-                       running_process->pid, request[0], request[1], request[2]);
+                log_event(EVENT_REQUEST, running_process, request, 0);
 
                 if (request_resources(running_process, request)) { // 尝试分配资源
                     // 资源分配成功后，再次检查是否达到最大需求
                     bool finished_after_request = true;
-                    for (int i = 0; i < NUM_RESOURCES; i++) {
+                    for (int i = 0; i < num_resources; i++) {
                         if (running_process->need[i] > 0) {
                             finished_after_request = false;
                             break;
@@ -401,7 +2539,9 @@ int main() {
                     }
 
                     if (finished_after_request) {
-                        printf("P%d 已达到最大需求，即将完成。\n", running_process->pid);
+                        if (verbosity >= VERBOSITY_EVENT) {
+                            printf("P%d 已达到最大需求，即将完成。\n", running_process->pid);
+                        }
                         running_process->state = FINISH;
                         finish_queue[finish_count++] = running_process; // 直接加入完成队列
                         release_resources(running_process);
@@ -416,15 +2556,28 @@ int main() {
                 enqueue(ready_queue, &ready_front, &ready_rear, running_process);
             }
         } else {
-            printf("就绪队列为空，系统空闲或所有进程都已完成/阻塞。\n");
+            if (verbosity >= VERBOSITY_EVENT) {
+                printf("就绪队列为空，系统空闲或所有进程都已完成/阻塞。\n");
+            }
             // 如果所有进程都阻塞，且无法唤醒（在当前轮次），则可能发生死锁，或者需要更长时间等待
-            if (is_queue_empty(ready_front, ready_rear) && !is_queue_empty(block_front, block_rear) && finish_count < NUM_PROCESSES) {
-                printf("系统可能进入死锁状态 (所有进程阻塞且无法继续前进)。\n");
+            if (is_queue_empty(ready_front, ready_rear) && block_count > 0 && finish_count < num_processes) {
+                // 检测模式下回滚死锁进程后继续；避免模式下理论上不会发生
+                if (banker_mode == DETECTION && recover_deadlock() > 0) {
+                    if (verbosity >= VERBOSITY_STATUS) {
+                        print_status();
+                    }
+                    continue;
+                }
+                if (verbosity >= VERBOSITY_RESULT) {
+                    printf("系统可能进入死锁状态 (所有进程阻塞且无法继续前进)。\n");
+                }
                 break; // 结束模拟
             }
         }
 
-        print_status();
+        if (verbosity >= VERBOSITY_STATUS) {
+            print_status();
+        }
 
         // 可选：添加一个小的延迟，便于观察输出
         // #ifdef _WIN32
@@ -433,8 +2586,182 @@ int main() {
         // usleep(500000); // 暂停0.5秒 (Linux/Unix)
         // #endif
     }
+    free_vectors(request);
+}
+
+// --- 死锁避免与检测的对比测试 ---
+
+// 在相同的初始状态和请求流上分别以避免模式、定期检测和停滞时检测运行模拟（不输出过程），
+// 比较每秒处理的请求数、阻塞时间和回滚浪费的资源。资源按默认总量和 40% 两档运行，后者争用激烈。
+// 所有进程从零分配开始，初始状态必然安全，两种模式在争用下都能真正运行；没有全部完成的运行标为停滞
+void run_detect_benchmark(unsigned int seed) {
+    static const int sizes[][2] = {{50, 4}, {200, 8}, {1000, 16}}; // 进程数, 资源种类数
+    static const int percents[] = {100, 40};
+    struct {
+        BankerMode mode;
+        int interval;
+        const char *name;
+    } configs[] = {
+        {AVOIDANCE, 0, "避免"},
+        {DETECTION, 10, "检测/10轮"},
+        {DETECTION, 0, "检测/停滞"},
+    };
+    printf("死锁避免与检测对比：随机种子 %u，阻塞时间以进程·轮计\n", seed);
+    printf("%-10s%-8s%-14s%-10s%-10s%-12s%-12s%-12s%-10s%-10s%-8s%s\n", "规模", "资源%", "模式", "完成", "轮次", "请求/秒",
+           "阻塞时间", "平均阻塞", "安全检查", "检测", "回滚", "浪费资源");
+    BankerMode saved_mode = banker_mode;
+    int saved_interval = detect_interval;
+    int saved_percent = resource_percent;
+    int saved_verbosity = verbosity;
+    verbosity = VERBOSITY_SILENT;
+    initial_allocation = false;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) * 2; s++) {
+        for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+            resource_percent = percents[s % 2];
+            num_processes = sizes[s / 2][0];
+            num_resources = sizes[s / 2][1];
+            banker_mode = configs[c].mode;
+            detect_interval = configs[c].interval;
+            alloc_banker();
+            init_processes(seed);
+            double start = wall_seconds();
+            run_simulation();
+            double elapsed = wall_seconds() - start;
+            char size[32], done[32], rate[32];
+            snprintf(size, sizeof(size), "%dx%d", num_processes, num_resources);
+            snprintf(done, sizeof(done), "%d/%d", finish_count, num_processes);
+            if (finish_count < num_processes) {
+                snprintf(rate, sizeof(rate), "停滞"); // 没跑完的吞吐量没有意义，单独标出
+            } else {
+                snprintf(rate, sizeof(rate), "%.0f", elapsed > 0 ? stats.requests / elapsed : 0.0);
+            }
+            printf("%-10s%-8d%-14s%-10s%-10d%-12s%-12lld%-12.1f%-10lld%-10lld%-8lld%lld\n", size, resource_percent,
+                   configs[c].name, done, stats.rounds, rate, stats.blocked_rounds,
+                   stats.blocks ? (double)stats.blocked_rounds / stats.blocks : 0.0,
+                   stats.safety_checks + wake_checks, stats.detections, stats.rollbacks, stats.wasted_units);
+            free_banker();
+        }
+    }
+    verbosity = saved_verbosity;
+    banker_mode = saved_mode;
+    detect_interval = saved_interval;
+    resource_percent = saved_percent;
+    initial_allocation = true;
+}
+
+void print_usage(const char *prog) {
+    printf("用法: %s [进程数 [资源种类数]] [--seed 种子] [--detect [检测间隔]] [--resource-percent 百分比]\n", prog);
+    printf("          [--verbosity 0-3] [--trace 轨迹文件 | --trace-binary 轨迹文件]\n");
+    printf("      %s --bench-safety [资源种类数] [--seed 种子]\n", prog);
+    printf("      %s --bench-vector [--seed 种子]\n", prog);
+    printf("      %s --bench-threads [最大线程数] [--seed 种子]\n", prog);
+    printf("      %s --bench-batch [--seed 种子]\n", prog);
+    printf("      %s --bench-detect [--seed 种子]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int seed = (unsigned int)time(NULL); // 默认使用当前时间作为随机数种子
+    bool bench_safety = false;
+    bool bench_vector = false;
+    int bench_threads = 0; // 压力测试的最大线程数，0 表示不运行
+    bool bench_batch = false;
+    bool bench_detect = false;
+    const char *trace_path = NULL;
+    bool trace_binary = false;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bench-safety") == 0) {
+            bench_safety = true;
+            num_resources = 64;
+        } else if (strcmp(argv[i], "--bench-vector") == 0) {
+            bench_vector = true;
+        } else if (strcmp(argv[i], "--bench-batch") == 0) {
+            bench_batch = true;
+        } else if (strcmp(argv[i], "--bench-detect") == 0) {
+            bench_detect = true;
+        } else if (strcmp(argv[i], "--detect") == 0) {
+            banker_mode = DETECTION;
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                detect_interval = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--verbosity") == 0 && i + 1 < argc) {
+            verbosity = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--trace") == 0 || strcmp(argv[i], "--trace-binary") == 0) && i + 1 < argc) {
+            trace_binary = (strcmp(argv[i], "--trace-binary") == 0);
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--resource-percent") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            resource_percent = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bench-threads") == 0) {
+            bench_threads = 16;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+                bench_threads = atoi(argv[++i]);
+            }
+        } else if (argv[i][0] != '-' && atoi(argv[i]) > 0 && positional < 2) {
+            if (bench_safety || positional == 1) {
+                num_resources = atoi(argv[i]);
+            } else {
+                num_processes = atoi(argv[i]);
+            }
+            positional++;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench_safety) {
+        run_safety_benchmark(num_resources, seed);
+        return 0;
+    }
+    if (bench_vector) {
+        run_vector_benchmark(seed);
+        return 0;
+    }
+    if (bench_batch) {
+        run_batch_benchmark(seed);
+        return 0;
+    }
+    if (bench_detect) {
+        run_detect_benchmark(seed);
+        return 0;
+    }
+    if (bench_threads > 0) {
+        run_thread_benchmark(bench_threads, seed);
+        return 0;
+    }
+
+    if (trace_path != NULL && !trace_open(trace_path, trace_binary)) {
+        return 1;
+    }
+    alloc_banker();
+    if (verbosity >= VERBOSITY_RESULT) {
+        printf("随机种子: %u\n", seed);
+        if (banker_mode == DETECTION) {
+            printf("死锁检测模式：%s\n", detect_interval > 0 ? "定期检测" : "所有进程阻塞时检测");
+        }
+    }
+    init_processes(seed);
+    double start = wall_seconds();
+    run_simulation();
+    double elapsed = wall_seconds() - start;
+    trace_close();
 
-    printf("\n--- 所有进程已完成或系统进入死锁状态，模拟结束。---\n");
+    if (verbosity >= VERBOSITY_RESULT) {
+        printf("\n--- 所有进程已完成或系统进入死锁状态，模拟结束。---\n");
+        printf("完成 %d/%d 个进程，共 %d 轮、%lld 个请求。\n", finish_count, num_processes, stats.rounds,
+               stats.requests);
+        // 耗时每次运行都不同，写到标准错误，使相同种子的标准输出逐字节相同
+        fprintf(stderr, "用时 %.3f 秒。\n", elapsed);
+        if (banker_mode == DETECTION) {
+            printf("死锁检测次数: %lld，检测到死锁 %lld 次，回滚进程 %lld 次，收回资源 %lld 个。\n",
+                   stats.detections, stats.deadlocks, stats.rollbacks, stats.wasted_units);
+        } else {
+            printf("唤醒阻塞进程时的安全性检查次数: %lld\n", wake_checks);
+        }
+    }
 
+    free_banker();
     return 0;
 }
@@ -2,10 +2,22 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h> // clock_gettime()，对比测试计时
+#ifdef _WIN32
+#include <windows.h> // QueryPerformanceCounter()
+#endif
 
 #define MAX_MEM_SIZE 640 // 初始内存大小 640KB
 #define MAX_JOBS     10 // 最大作业数量
 
+// 两级分离适应 (TLSF) 的参数：分区大小按最高位分到一级区间 [2^f, 2^(f+1))，
+// 每个一级区间再等分成 2^TLSF_SL_LOG2 个二级区间；小于 TLSF_SMALL_SIZE 的分区都在一级区间 0 中，按大小逐个划分
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_SMALL_SIZE TLSF_SL_COUNT
+#define TLSF_FL_MAX 30                                 // 最大分区不超过 2^31 - 1 KB
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_SL_LOG2 + 2) // 一级区间 0 加上 [2^4, 2^31) 的各区间
+
 // 定义内存分区结构体
 typedef struct Partition {
     int start_address; // 分区起始地址
@@ -13,13 +25,27 @@ typedef struct Partition {
     bool is_free;      // 是否空闲
     char job_name[20]; // 如果非空闲，记录作业名
     struct Partition *next; // 指向下一个分区
+    // 以下仅用于 TLSF：next 指向同一分级空闲链表中的下一个分区
+    struct Partition *prev_free; // 分级空闲链表中的前一个分区
+    struct Partition *prev_phys; // 地址相邻的前一个分区（空闲或已分配）
+    struct Partition *next_phys; // 地址相邻的后一个分区
 } Partition;
 
+int memory_size = MAX_MEM_SIZE; // 内存总大小 (KB)，对比测试时使用更大的内存
+
 // 空闲分区链表头指针 (按地址排序)
 Partition *free_partitions_head = NULL;
 // 已分配分区链表头指针
 Partition *allocated_partitions_head = NULL;
 
+// TLSF 的分级空闲链表：tlsf_lists[f][s] 为一级区间 f、二级区间 s 的空闲分区链表。
+// 一级位图的第 f 位表示一级区间 f 中有空闲分区，tlsf_sl_bitmap[f] 的第 s 位表示 tlsf_lists[f][s] 非空
+Partition *tlsf_lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+unsigned int tlsf_fl_bitmap = 0;
+unsigned int tlsf_sl_bitmap[TLSF_FL_COUNT];
+Partition *tlsf_first = NULL; // 地址为 0 的分区，沿 next_phys 可按地址遍历所有分区
+bool tlsf_active = false;     // 当前是否使用 TLSF 管理空闲分区
+
 // --- 辅助函数 ---
 
 // 创建新的分区节点
@@ -34,9 +60,51 @@ Partition* create_partition(int start, int size, bool is_free, const char* job_n
     new_node->is_free = is_free;
     strcpy(new_node->job_name, job_name);
     new_node->next = NULL;
+    new_node->prev_free = NULL;
+    new_node->prev_phys = NULL;
+    new_node->next_phys = NULL;
     return new_node;
 }
 
+// 最高置位位的序号，x 不为 0
+int highest_bit(unsigned int x) {
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    int b = 0;
+    while (x >>= 1) {
+        b++;
+    }
+    return b;
+#endif
+}
+
+// 最低置位位的序号，x 不为 0
+int lowest_bit(unsigned int x) {
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    int b = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+// 计算大小为 size 的分区所在的一级、二级区间
+void tlsf_mapping(int size, int *fl, int *sl) {
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size;
+    } else {
+        int f = highest_bit((unsigned int)size);
+        *sl = (size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT; // 去掉最高位后的次高 TLSF_SL_LOG2 位
+        *fl = f - TLSF_SL_LOG2 + 1;
+    }
+}
+
 // 打印内存状态
 void print_memory_status() {
     printf("\n--- 当前内存状态 ---\n");
@@ -52,6 +120,25 @@ void print_memory_status() {
         }
     }
 
+    if (tlsf_active) { // TLSF 的空闲分区分散在各分级链表中，沿地址相邻关系按地址列出
+        printf("\n空闲分区 (TLSF 分级空闲链表，按地址列出):\n");
+        bool any_free = false;
+        for (Partition *current = tlsf_first; current != NULL; current = current->next_phys) {
+            if (current->is_free) {
+                int fl, sl;
+                tlsf_mapping(current->size, &fl, &sl);
+                printf("  起始地址: %4dKB | 大小: %4dKB | 一级区间: %2d | 二级区间: %2d\n",
+                       current->start_address, current->size, fl, sl);
+                any_free = true;
+            }
+        }
+        if (!any_free) {
+            printf("  (无)\n");
+        }
+        printf("--------------------\n");
+        return;
+    }
+
     printf("\n空闲分区链表 (按地址排序):\n");
     if (free_partitions_head == NULL) {
         printf("  (无)\n");
@@ -168,7 +255,7 @@ Partition* best_fit(int request_size) {
     Partition *best_fit_part = NULL;
     Partition *best_fit_prev = NULL;
     Partition *prev = NULL;
-    int min_fragment = MAX_MEM_SIZE + 1; // 记录最小碎片大小
+    int min_fragment = memory_size + 1; // 记录最小碎片大小
 
     while (current != NULL) {
         if (current->size >= request_size) {
@@ -205,9 +292,160 @@ Partition* best_fit(int request_size) {
     return NULL; // 未找到合适分区
 }
 
+// --- 两级分离适应算法 (TLSF) ---
+// 空闲分区按大小分到 (一级, 二级) 区间的链表中，用两级位图找到非空链表，申请和回收都是 O(1)，与空闲分区数无关。
+// 申请时把请求大小向上取整到下一个二级区间的下界，该区间及以上链表中的任一分区都足够大，直接取链表头，
+// 相当于近似的最佳适应；代价是同一二级区间内恰好够大的分区会被跳过。
+// 回收时通过地址相邻的 prev_phys/next_phys 直接找到前后分区合并，不需要遍历按地址排序的链表
+
+// 把空闲分区放入对应的分级链表头部
+void tlsf_insert_block(Partition *block) {
+    int fl, sl;
+    tlsf_mapping(block->size, &fl, &sl);
+    block->is_free = true;
+    block->prev_free = NULL;
+    block->next = tlsf_lists[fl][sl];
+    if (block->next != NULL) {
+        block->next->prev_free = block;
+    }
+    tlsf_lists[fl][sl] = block;
+    tlsf_fl_bitmap |= 1U << fl;
+    tlsf_sl_bitmap[fl] |= 1U << sl;
+}
+
+// 把空闲分区从分级链表中摘下，链表变空时清除位图中的对应位
+void tlsf_remove_block(Partition *block) {
+    int fl, sl;
+    tlsf_mapping(block->size, &fl, &sl);
+    if (block->prev_free != NULL) {
+        block->prev_free->next = block->next;
+    } else {
+        tlsf_lists[fl][sl] = block->next;
+    }
+    if (block->next != NULL) {
+        block->next->prev_free = block->prev_free;
+    }
+    block->next = NULL;
+    block->prev_free = NULL;
+    if (tlsf_lists[fl][sl] == NULL) {
+        tlsf_sl_bitmap[fl] &= ~(1U << sl);
+        if (tlsf_sl_bitmap[fl] == 0) {
+            tlsf_fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+// 用整块内存初始化 TLSF
+void tlsf_init(int total_size) {
+    memset(tlsf_lists, 0, sizeof(tlsf_lists));
+    memset(tlsf_sl_bitmap, 0, sizeof(tlsf_sl_bitmap));
+    tlsf_fl_bitmap = 0;
+    tlsf_first = create_partition(0, total_size, true, "");
+    tlsf_insert_block(tlsf_first);
+    tlsf_active = true;
+}
+
+// TLSF 分配
+Partition* tlsf_fit(int request_size) {
+    int search_size = request_size;
+    if (search_size >= TLSF_SMALL_SIZE) { // 向上取整到下一个二级区间的下界
+        search_size += (1 << (highest_bit((unsigned int)search_size) - TLSF_SL_LOG2)) - 1;
+    }
+    int fl, sl;
+    tlsf_mapping(search_size, &fl, &sl);
+    if (fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    // 先在同一一级区间中找不小于 sl 的二级区间，没有时取更高的一级区间中最小的非空二级区间
+    unsigned int sl_map = tlsf_sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        unsigned int fl_map = tlsf_fl_bitmap & (~0U << (fl + 1));
+        if (fl_map == 0) {
+            return NULL; // 未找到合适分区
+        }
+        fl = lowest_bit(fl_map);
+        sl_map = tlsf_sl_bitmap[fl];
+    }
+    sl = lowest_bit(sl_map);
+    Partition *block = tlsf_lists[fl][sl];
+    tlsf_remove_block(block);
+
+    if (block->size - request_size > 0) { // 需要分裂，剩余部分作为新的空闲分区
+        Partition *rest = create_partition(block->start_address + request_size, block->size - request_size, true, "");
+        rest->prev_phys = block;
+        rest->next_phys = block->next_phys;
+        if (block->next_phys != NULL) {
+            block->next_phys->prev_phys = rest;
+        }
+        block->next_phys = rest;
+        block->size = request_size;
+        tlsf_insert_block(rest);
+    }
+    block->is_free = false;
+    return block;
+}
+
+// TLSF 回收：与地址相邻的空闲分区合并后放回分级链表
+void tlsf_release(Partition *block) {
+    Partition *prev = block->prev_phys;
+    if (prev != NULL && prev->is_free) { // 向前合并
+        tlsf_remove_block(prev);
+        prev->size += block->size;
+        prev->next_phys = block->next_phys;
+        if (block->next_phys != NULL) {
+            block->next_phys->prev_phys = prev;
+        }
+        free(block);
+        block = prev;
+    }
+    Partition *next = block->next_phys;
+    if (next != NULL && next->is_free) { // 向后合并
+        tlsf_remove_block(next);
+        block->size += next->size;
+        block->next_phys = next->next_phys;
+        if (next->next_phys != NULL) {
+            next->next_phys->prev_phys = block;
+        }
+        free(next);
+    }
+    tlsf_insert_block(block);
+}
+
 
 // --- 内存管理操作 ---
 
+// 按所选算法初始化内存：整个内存作为一个大空闲分区
+void init_memory(int algorithm_choice) {
+    if (algorithm_choice == 3) {
+        tlsf_init(memory_size);
+    } else {
+        tlsf_active = false;
+        free_partitions_head = create_partition(0, memory_size, true, "");
+    }
+}
+
+// 按所选算法分配分区，失败返回 NULL
+Partition* find_partition(int request_size, int algorithm_choice) {
+    if (algorithm_choice == 1) {
+        return first_fit(request_size);
+    } else if (algorithm_choice == 2) {
+        return best_fit(request_size);
+    }
+    return tlsf_fit(request_size);
+}
+
+// 把已从已分配链表中移除的分区归还给空闲分区管理（之后 part 可能已因合并被释放）
+void release_partition(Partition *part) {
+    part->is_free = true;
+    strcpy(part->job_name, ""); // 清空作业名
+    if (tlsf_active) {
+        tlsf_release(part);
+    } else {
+        insert_free_partition(part); // 插入并尝试合并
+    }
+}
+
 // 内存分配
 void allocate_memory(const char *job_name, int request_size, int algorithm_choice) {
     printf("\n--- 申请内存 ---\n");
@@ -226,14 +464,15 @@ void allocate_memory(const char *job_name, int request_size, int algorithm_choic
     Partition *allocated_part = NULL;
     if (algorithm_choice == 1) { // 首次适应
         printf("使用首次适应算法...\n");
-        allocated_part = first_fit(request_size);
     } else if (algorithm_choice == 2) { // 最佳适应
         printf("使用最佳适应算法...\n");
-        allocated_part = best_fit(request_size);
+    } else if (algorithm_choice == 3) { // 两级分离适应
+        printf("使用两级分离适应算法 (TLSF)...\n");
     } else {
         printf("无效的算法选择。\n");
         return;
     }
+    allocated_part = find_partition(request_size, algorithm_choice);
 
     if (allocated_part != NULL) {
         strcpy(allocated_part->job_name, job_name);
@@ -280,18 +519,32 @@ void free_memory(const char *job_name) {
         prev_alloc->next = current_alloc->next;
     }
 
+    // 合并时分区节点可能被释放，先记下大小和地址
+    int recycled_size = recycled_part->size;
+    int recycled_start = recycled_part->start_address;
+
     // 将回收的分区转换为空闲分区并插入空闲链表
-    recycled_part->is_free = true;
-    strcpy(recycled_part->job_name, ""); // 清空作业名
-    insert_free_partition(recycled_part); // 插入并尝试合并
+    release_partition(recycled_part);
 
     printf("成功回收作业 %s 的 %dKB 内存，起始地址: %dKB。\n",
-           job_name, recycled_part->size, recycled_part->start_address);
+           job_name, recycled_size, recycled_start);
     print_memory_status();
 }
 
-// 清理所有内存
-void cleanup_memory() {
+// 释放所有分区节点
+void release_all_partitions() {
+    if (tlsf_active) { // TLSF 的所有分区（空闲和已分配）都在地址相邻的链表上
+        Partition *current = tlsf_first;
+        while (current != NULL) {
+            Partition *temp = current;
+            current = current->next_phys;
+            free(temp);
+        }
+        tlsf_first = NULL;
+        allocated_partitions_head = NULL;
+        tlsf_active = false;
+        return;
+    }
     Partition *current = free_partitions_head;
     while (current != NULL) {
         Partition *temp = current;
@@ -307,13 +560,231 @@ void cleanup_memory() {
         free(temp);
     }
     allocated_partitions_head = NULL;
+}
+
+// 清理所有内存
+void cleanup_memory() {
+    release_all_partitions();
     printf("\n所有内存已清理。\n");
 }
 
+// --- 大规模请求序列对比测试 ---
+// 在同一个随机生成的申请/释放序列上比较三种算法：申请和回收的耗时分布、申请失败次数，
+// 以及定期采样的空闲分区数和外部碎片率 (1 - 最大空闲分区 / 空闲总量)
+
+#define BENCH_MEM_SIZE (1 << 20)   // 对比测试的内存大小 1GB (以 KB 计)
+#define BENCH_SIZE_CLASSES 10      // 申请大小先均匀选取 [2^e, 2^(e+1)) 中的 e (0–9)，即 1KB–1MB 近似按对数均匀分布
+#define BENCH_SAMPLE_INTERVAL 1000 // 每隔多少次操作采样一次空闲分区
+
+typedef struct {
+    int job;  // 作业编号
+    int size; // 申请大小 (KB)，0 表示释放该作业
+} TraceOp;
+
+// 单调时钟，单位纳秒
+long long now_ns() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (long long)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+int compare_long_long(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// 统计当前的空闲分区：个数、总大小和最大空闲分区
+void free_space_stats(int *count, long long *total, int *largest) {
+    *count = 0;
+    *total = 0;
+    *largest = 0;
+    Partition *current = tlsf_active ? tlsf_first : free_partitions_head;
+    while (current != NULL) {
+        if (current->is_free) {
+            (*count)++;
+            *total += current->size;
+            if (current->size > *largest) {
+                *largest = current->size;
+            }
+        }
+        current = tlsf_active ? current->next_phys : current->next;
+    }
+}
+
+// 生成 count 次操作的随机序列，返回作业总数。同时存在的作业数在 live_target 的一半到 live_target 之间
+// 随机游走；已释放的作业编号不再使用
+int generate_trace(TraceOp *ops, int count, int live_target, unsigned int seed) {
+    srand(seed);
+    int *live = (int *)malloc(sizeof(int) * live_target);
+    if (live == NULL) {
+        perror("Failed to allocate memory for trace");
+        exit(EXIT_FAILURE);
+    }
+    int live_count = 0, jobs = 0;
+    for (int i = 0; i < count; i++) {
+        bool allocate = live_count < live_target / 2 || (live_count < live_target && rand() % 2 == 0);
+        if (allocate) {
+            int e = rand() % BENCH_SIZE_CLASSES;
+            ops[i].job = jobs;
+            ops[i].size = (1 << e) + rand() % (1 << e);
+            live[live_count++] = jobs++;
+        } else { // 随机释放一个现存作业
+            int k = rand() % live_count;
+            ops[i].job = live[k];
+            ops[i].size = 0;
+            live[k] = live[--live_count];
+        }
+    }
+    free(live);
+    return jobs;
+}
+
+// 用一种算法回放操作序列并输出一行统计
+void run_trace(const TraceOp *ops, int count, int num_jobs, int algorithm_choice, const char *name) {
+    memory_size = BENCH_MEM_SIZE;
+    init_memory(algorithm_choice);
+    Partition **jobs = (Partition **)calloc(num_jobs, sizeof(Partition *));
+    long long *alloc_ns = (long long *)malloc(sizeof(long long) * count);
+    long long *free_ns = (long long *)malloc(sizeof(long long) * count);
+    if (jobs == NULL || alloc_ns == NULL || free_ns == NULL) {
+        perror("Failed to allocate memory for benchmark");
+        exit(EXIT_FAILURE);
+    }
+    int allocs = 0, frees = 0, failures = 0, samples = 0;
+    double blocks_sum = 0, fragmentation_sum = 0;
+    long long start = now_ns();
+    for (int i = 0; i < count; i++) {
+        const TraceOp *op = &ops[i];
+        if (op->size > 0) {
+            long long t = now_ns();
+            Partition *part = find_partition(op->size, algorithm_choice);
+            alloc_ns[allocs++] = now_ns() - t;
+            jobs[op->job] = part;
+            if (part == NULL) {
+                failures++;
+            }
+        } else if (jobs[op->job] != NULL) { // 申请失败的作业不需要释放
+            long long t = now_ns();
+            release_partition(jobs[op->job]);
+            free_ns[frees++] = now_ns() - t;
+            jobs[op->job] = NULL;
+        }
+        if ((i + 1) % BENCH_SAMPLE_INTERVAL == 0) {
+            int free_count, largest;
+            long long free_total;
+            free_space_stats(&free_count, &free_total, &largest);
+            blocks_sum += free_count;
+            fragmentation_sum += free_total > 0 ? 1.0 - (double)largest / free_total : 0.0;
+            samples++;
+        }
+    }
+    double total_ms = (now_ns() - start) / 1e6;
+
+    // 释放剩余作业后所有空闲分区应合并回一整块，用来检查合并是否正确
+    for (int j = 0; j < num_jobs; j++) {
+        if (jobs[j] != NULL) {
+            release_partition(jobs[j]);
+        }
+    }
+    int free_count, largest;
+    long long free_total;
+    free_space_stats(&free_count, &free_total, &largest);
+    bool intact = (free_count == 1 && largest == BENCH_MEM_SIZE);
+
+    qsort(alloc_ns, allocs, sizeof(long long), compare_long_long);
+    qsort(free_ns, frees, sizeof(long long), compare_long_long);
+    double alloc_mean = 0, free_mean = 0;
+    for (int i = 0; i < allocs; i++) {
+        alloc_mean += alloc_ns[i];
+    }
+    for (int i = 0; i < frees; i++) {
+        free_mean += free_ns[i];
+    }
+    alloc_mean = allocs ? alloc_mean / allocs : 0;
+    free_mean = frees ? free_mean / frees : 0;
+    printf("%-8s %10.0f %10lld %10.0f %10lld %8d %10.1f %10.2f %10.1f   %s\n", name,
+           alloc_mean, allocs ? alloc_ns[(size_t)((allocs - 1) * 0.99)] : 0,
+           free_mean, frees ? free_ns[(size_t)((frees - 1) * 0.99)] : 0,
+           failures, samples ? blocks_sum / samples : 0.0,
+           samples ? 100.0 * fragmentation_sum / samples : 0.0, total_ms, intact ? "正确" : "错误");
+
+    release_all_partitions();
+    free(jobs);
+    free(alloc_ns);
+    free(free_ns);
+}
+
+// 在两档负载下生成 count 次操作的请求序列，依次用三种算法回放：同时存在 2500-5000 个作业时平均约占内存的一半，
+// 6000-12000 个作业时内存经常接近用满，申请失败次数反映各算法的碎片情况
+void run_benchmark(int count, unsigned int seed) {
+    static const int live_targets[] = {5000, 12000};
+    TraceOp *ops = (TraceOp *)malloc(sizeof(TraceOp) * count);
+    if (ops == NULL) {
+        perror("Failed to allocate memory for trace");
+        exit(EXIT_FAILURE);
+    }
+    printf("请求序列对比：%d 次操作，内存 %dKB，申请 1KB-1MB，随机种子 %u\n", count, BENCH_MEM_SIZE, seed);
+    printf("耗时为单次操作的纳秒数（含计时开销），空闲分区数和外部碎片率每 %d 次操作采样一次取平均\n",
+           BENCH_SAMPLE_INTERVAL);
+    for (int t = 0; t < 2; t++) {
+        int num_jobs = generate_trace(ops, count, live_targets[t], seed);
+        printf("\n同时存在 %d-%d 个作业（共 %d 个作业）:\n", live_targets[t] / 2, live_targets[t], num_jobs);
+        printf("%-8s %10s %10s %10s %10s %8s %10s %10s %10s   %s\n", "算法", "申请均值", "申请p99", "回收均值",
+               "回收p99", "失败", "空闲分区", "外部碎片%", "总耗时ms", "合并检查");
+        run_trace(ops, count, num_jobs, 1, "FirstFit");
+        run_trace(ops, count, num_jobs, 2, "BestFit");
+        run_trace(ops, count, num_jobs, 3, "TLSF");
+    }
+    free(ops);
+}
+
 // --- 主函数 ---
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1) { // test_3 --bench [操作数] [--seed 种子]
+        int count = 200000;
+        unsigned int seed = (unsigned int)time(NULL);
+        bool bench = false;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--bench") == 0) {
+                bench = true;
+                if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+                    count = atoi(argv[++i]);
+                }
+            } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+            } else {
+                bench = false;
+                break;
+            }
+        }
+        if (!bench) {
+            printf("用法: %s\n      %s --bench [操作数] [--seed 种子]\n", argv[0], argv[0]);
+            return 1;
+        }
+        run_benchmark(count, seed);
+        return 0;
+    }
+
+    int choice;
+    printf("请选择内存分配算法:\n");
+    printf("1. 首次适应算法 (First Fit)\n");
+    printf("2. 最佳适应算法 (Best Fit)\n");
+    printf("3. 两级分离适应算法 (TLSF)\n");
+    printf("请输入数字 (1、2或3): ");
+    if (scanf("%d", &choice) != 1 || choice < 1 || choice > 3) {
+        printf("无效的选择。程序将退出。\n");
+        return 1;
+    }
+
     // 初始状态：整个内存作为一个大空闲分区
-    free_partitions_head = create_partition(0, MAX_MEM_SIZE, true, "");
+    init_memory(choice);
     printf("初始内存状态 (总大小: %dKB):\n", MAX_MEM_SIZE);
     print_memory_status();
 
@@ -339,18 +810,6 @@ int main() {
     };
     int num_requests = sizeof(requests) / sizeof(requests[0]);
 
-    int choice;
-    printf("请选择内存分配算法:\n");
-    printf("1. 首次适应算法 (First Fit)\n");
-    printf("2. 最佳适应算法 (Best Fit)\n");
-    printf("请输入数字 (1或2): ");
-    scanf("%d", &choice);
-
-    if (choice != 1 && choice != 2) {
-        printf("无效的选择。程序将退出。\n");
-        return 1;
-    }
-
     for (int i = 0; i < num_requests; ++i) {
         printf("\n\n=============== 执行请求 %d: %s %s %dKB ===============\n",
                i + 1, requests[i].job_name, requests[i].operation_type, requests[i].size);